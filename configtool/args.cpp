@@ -73,6 +73,63 @@ bool args::is_control_delta(std::string const &arg) {
 	return (arg == control_delta_arg);
 }
 
+/**
+ * @brief determines if a signal type of the receiver is to be set and if which one
+ */
+bool args::is_input_mode(std::string const &arg, E_INPUT_MODE *value) {
+	std::string const prefix = "-input-"; // -input-ppm => ppm sum signal on the ch1 pin
+	if(arg.compare(0, prefix.size(), prefix) != 0) return false;
+	std::string const mode = arg.substr(prefix.size());
+	if(mode == "pwm") *value = INPUT_PWM;
+	else if(mode == "ppm") *value = INPUT_PPM;
+	else if(mode == "sbus") *value = INPUT_SBUS;
+	else if(mode == "ibus") *value = INPUT_IBUS;
+	else if(mode == "crsf") *value = INPUT_CRSF;
+	else if(mode == "oneshot125") *value = INPUT_ONESHOT125;
+	else if(mode == "oneshot42") *value = INPUT_ONESHOT42;
+	else if(mode == "multishot") *value = INPUT_MULTISHOT;
+	else if(mode == "dshot150") *value = INPUT_DSHOT150;
+	else if(mode == "auto") *value = INPUT_AUTO;
+	else throw std::runtime_error("Value provided for -input- is not supported (pwm, ppm, sbus, ibus, crsf, oneshot125, oneshot42, multishot, dshot150 or auto)");
+	return true;
+}
+
+/**
+ * @brief determines if an input timeout is to be set and if which value
+ */
+bool args::is_input_timeout(std::string const &arg, size_t *value) {
+	std::string const input_timeout_arg = "-input-timeout"; // -input-timeout-60 => motors off after 60 ms without a pulse on a channel
+	size_t const pos_last_minus = arg.rfind("-");
+	if(pos_last_minus == std::string::npos) return false;
+	if(input_timeout_arg != arg.substr(0, pos_last_minus)) return false;
+	std::string input_timeout_value = arg.substr(pos_last_minus + 1);
+	unsigned int tmp_val = 0;
+	try {
+		tmp_val = boost::lexical_cast<unsigned int>(input_timeout_value);
+	} catch(boost::bad_lexical_cast &e) {
+		throw std::runtime_error("Could not convert number of -input-timeout argument from string to number");
+	}
+	if(tmp_val < 20 || tmp_val > 255) throw std::runtime_error("Value provided for -input-timeout is out of allowed boundaries (20 - 255 ms)");
+	*value = static_cast<size_t>(tmp_val);
+	return true;
+}
+
+/**
+ * @brief determines if a limit of the pulse validation (width in us, frame period in ms) is to be set and if which value
+ */
+bool args::is_pulse_width_min(std::string const &arg, size_t *value) {
+	return args::util_convert_value(arg, "-pulse-width-min", 500, 2500, value); // -pulse-width-min-800 => shorter pulses are rejected
+}
+bool args::is_pulse_width_max(std::string const &arg, size_t *value) {
+	return args::util_convert_value(arg, "-pulse-width-max", 500, 2500, value);
+}
+bool args::is_frame_period_min(std::string const &arg, size_t *value) {
+	return args::util_convert_value(arg, "-frame-period-min", 2, 255, value); // -frame-period-min-3 => pulses closer than 3 ms to the previous one are rejected
+}
+bool args::is_frame_period_max(std::string const &arg, size_t *value) {
+	return args::util_convert_value(arg, "-frame-period-max", 2, 255, value);
+}
+
 /**
  * @brief determines if a deadzone is to be set
  */
@@ -156,6 +213,120 @@ bool args::is_rc_ch2_max(std::string const &arg, size_t *value) {
 	return true;
 }
 
+/**
+ * @brief determines if a filter kernel for ch x is to be set and if which one with which parameter
+ */
+bool args::is_filter_ch1(std::string const &arg, E_FILTER_KERNEL *kernel, size_t *param) {
+	return args::util_convert_filter(arg, "-filter-ch1-", kernel, param); // -filter-ch1-median-3 => median of the last 3 values of ch 1
+}
+bool args::is_filter_ch2(std::string const &arg, E_FILTER_KERNEL *kernel, size_t *param) {
+	return args::util_convert_filter(arg, "-filter-ch2-", kernel, param);
+}
+
+/**
+ * @brief determines if a pwm frequency is to be set and if which value
+ */
+bool args::is_pwm_frequency(std::string const &arg, E_PWM_FREQUENCY *value) {
+	std::string const pwm_frequency_arg = "-pwm-frequency"; // -pwm-frequency-16 => pwm frequency of 16 kHz
+	size_t const pos_last_minus = arg.rfind("-");
+	if(pos_last_minus == std::string::npos) return false;
+	if(pwm_frequency_arg != arg.substr(0, pos_last_minus)) return false;
+	std::string pwm_frequency_value = arg.substr(pos_last_minus + 1);
+	unsigned int tmp_val = 0;
+	try {
+		tmp_val = boost::lexical_cast<unsigned int>(pwm_frequency_value);
+	} catch(boost::bad_lexical_cast &e) {
+		throw std::runtime_error("Could not convert number of -pwm-frequency argument from string to number");
+	}
+	switch(tmp_val) {
+	case 1: *value = PWM_1KHZ; break;
+	case 4: *value = PWM_4KHZ; break;
+	case 8: *value = PWM_8KHZ; break;
+	case 16: *value = PWM_16KHZ; break;
+	case 20: *value = PWM_20KHZ; break;
+	default: throw std::runtime_error("Value provided for -pwm-frequency is not supported (1, 4, 8, 16 or 20 kHz)");
+	}
+	return true;
+}
+
+/**
+ * @brief determines the phase relation of the pwm of both motors
+ */
+bool args::is_pwm_in_phase(std::string const &arg) {
+	std::string const pwm_in_phase_arg = "-pwm-in-phase";
+	return (arg == pwm_in_phase_arg);
+}
+bool args::is_pwm_interleaved(std::string const &arg) {
+	std::string const pwm_interleaved_arg = "-pwm-interleaved"; // the right motor is switched on half a period after the left one
+	return (arg == pwm_interleaved_arg);
+}
+
+/**
+ * @brief determines if the dithering of the pwm duty cycle is to be switched on or off
+ */
+bool args::is_pwm_dithering_on(std::string const &arg) {
+	std::string const pwm_dithering_on_arg = "-pwm-dithering-on";
+	return (arg == pwm_dithering_on_arg);
+}
+bool args::is_pwm_dithering_off(std::string const &arg) {
+	std::string const pwm_dithering_off_arg = "-pwm-dithering-off";
+	return (arg == pwm_dithering_off_arg);
+}
+
+/**
+ * @brief determines if the aux output is to be driven by a receiver channel and if by which one or if it is to be switched off
+ */
+bool args::is_aux_channel(std::string const &arg, size_t *value) {
+	return args::util_convert_value(arg, "-aux-channel", 1, 16, value); // -aux-channel-3 => ch 3 of the frame sets the duty cycle of the aux output
+}
+bool args::is_aux_off(std::string const &arg) {
+	std::string const aux_off_arg = "-aux-off";
+	return (arg == aux_off_arg);
+}
+
+/**
+ * @brief determines if a drive mode for the left/right motor is to be set and if which one
+ */
+bool args::is_drive_mode_left(std::string const &arg, E_DRIVE_MODE *value) {
+	return args::util_convert_drive_mode(arg, "-drive-mode-left-", value); // -drive-mode-left-brake => left motor brakes during the pwm off time
+}
+bool args::is_drive_mode_right(std::string const &arg, E_DRIVE_MODE *value) {
+	return args::util_convert_drive_mode(arg, "-drive-mode-right-", value);
+}
+
+/**
+ * @brief determines if a reversal dead time is to be set and if which value
+ */
+bool args::is_dead_time(std::string const &arg, size_t *value) {
+	std::string const dead_time_arg = "-dead-time"; // -dead-time-500 => 500 us without drive before a motor reverses
+	size_t const pos_last_minus = arg.rfind("-");
+	if(pos_last_minus == std::string::npos) return false;
+	if(dead_time_arg != arg.substr(0, pos_last_minus)) return false;
+	std::string dead_time_value = arg.substr(pos_last_minus + 1);
+	unsigned int tmp_val = 0;
+	try {
+		tmp_val = boost::lexical_cast<unsigned int>(dead_time_value);
+	} catch(boost::bad_lexical_cast &e) {
+		throw std::runtime_error("Could not convert number of -dead-time argument from string to number");
+	}
+	if(tmp_val > 5000) throw std::runtime_error("Value provided for -dead-time is out of allowed boundaries (0 - 5000 us)");
+	*value = static_cast<size_t>(tmp_val);
+	return true;
+}
+
+/**
+ * @brief determines if a acceleration/deceleration/reversal slew rate is to be set and if which value
+ */
+bool args::is_accel_rate(std::string const &arg, size_t *value) {
+	return args::util_convert_rate(arg, "-accel-rate", value); // -accel-rate-2 => the speed rises by at most 2/255 per ms
+}
+bool args::is_decel_rate(std::string const &arg, size_t *value) {
+	return args::util_convert_rate(arg, "-decel-rate", value);
+}
+bool args::is_reversal_rate(std::string const &arg, size_t *value) {
+	return args::util_convert_rate(arg, "-reversal-rate", value);
+}
+
 /**
  * @brief returns true if arg is -display, false otherwise
  */
@@ -172,3 +343,76 @@ size_t args::util_convert_from_ms_rc_min_max(float const value) {
 	if(value >= 0.9f && value <= 2.1f) return static_cast<size_t>((value - 1.0f) * 250.0f);
 	else throw std::runtime_error("Value provided for chx_min/max_value is out of allowed boundaries (0.9 - 2.1 ms)");
 }
+
+/**
+ * @brief converts the mode name of the -drive-mode-left/right- arguments to the drive mode, returns false if the argument does not start with prefix
+ */
+bool args::util_convert_drive_mode(std::string const &arg, std::string const &prefix, E_DRIVE_MODE *value) {
+	if(arg.compare(0, prefix.size(), prefix) != 0) return false;
+	std::string const mode = arg.substr(prefix.size());
+	if(mode == "coast") *value = COAST;
+	else if(mode == "brake") *value = BRAKE;
+	else if(mode == "drive-brake") *value = DRIVE_BRAKE;
+	else throw std::runtime_error("Value provided for " + prefix + " is not supported (coast, brake or drive-brake)");
+	return true;
+}
+
+/**
+ * @brief converts the kernel and its parameter of the -filter-ch1/ch2- arguments, returns false if the argument does not start with prefix
+ */
+bool args::util_convert_filter(std::string const &arg, std::string const &prefix, E_FILTER_KERNEL *kernel, size_t *param) {
+	if(arg.compare(0, prefix.size(), prefix) != 0) return false;
+	if(arg.substr(prefix.size()) == "bypass") {
+		*kernel = FILTER_BYPASS;
+		*param = 0;
+	} else if(args::util_convert_value(arg, prefix + "average", 1, 16, param)) {
+		*kernel = FILTER_AVERAGE;
+	} else if(args::util_convert_value(arg, prefix + "median", 3, 5, param) && *param != 4) {
+		*kernel = FILTER_MEDIAN;
+	} else if(args::util_convert_value(arg, prefix + "iir", 1, 255, param)) {
+		*kernel = FILTER_IIR;
+	} else if(args::util_convert_value(arg, prefix + "adaptive", 1, 255, param)) {
+		*kernel = FILTER_ADAPTIVE;
+	} else {
+		throw std::runtime_error("Value provided for " + prefix + " is not supported (average-1 to average-16, median-3, median-5, iir-1 to iir-255, adaptive-1 to adaptive-255 or bypass)");
+	}
+	return true;
+}
+
+/**
+ * @brief converts the value of the -accel/decel/reversal-rate arguments, returns false if the argument is not rate_arg
+ */
+bool args::util_convert_rate(std::string const &arg, std::string const &rate_arg, size_t *value) {
+	size_t const pos_last_minus = arg.rfind("-");
+	if(pos_last_minus == std::string::npos) return false;
+	if(rate_arg != arg.substr(0, pos_last_minus)) return false;
+	std::string rate_value = arg.substr(pos_last_minus + 1);
+	unsigned int tmp_val = 0;
+	try {
+		tmp_val = boost::lexical_cast<unsigned int>(rate_value);
+	} catch(boost::bad_lexical_cast &e) {
+		throw std::runtime_error("Could not convert number of " + rate_arg + " argument from string to number");
+	}
+	if(tmp_val > 255) throw std::runtime_error("Value provided for " + rate_arg + " is out of allowed boundaries (0 - 255)");
+	*value = static_cast<size_t>(tmp_val);
+	return true;
+}
+
+/**
+ * @brief converts the integer value of the argument value_arg within min - max, returns false if the argument is not value_arg
+ */
+bool args::util_convert_value(std::string const &arg, std::string const &value_arg, unsigned int const min, unsigned int const max, size_t *value) {
+	size_t const pos_last_minus = arg.rfind("-");
+	if(pos_last_minus == std::string::npos) return false;
+	if(value_arg != arg.substr(0, pos_last_minus)) return false;
+	std::string value_str = arg.substr(pos_last_minus + 1);
+	unsigned int tmp_val = 0;
+	try {
+		tmp_val = boost::lexical_cast<unsigned int>(value_str);
+	} catch(boost::bad_lexical_cast &e) {
+		throw std::runtime_error("Could not convert number of " + value_arg + " argument from string to number");
+	}
+	if(tmp_val < min || tmp_val > max) throw std::runtime_error("Value provided for " + value_arg + " is out of allowed boundaries (" + boost::lexical_cast<std::string>(min) + " - " + boost::lexical_cast<std::string>(max) + ")");
+	*value = static_cast<size_t>(tmp_val);
+	return true;
+}
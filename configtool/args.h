@@ -28,6 +28,7 @@
 
 #include <queue>
 #include <string>
+#include "configuration.h"
 
 class args {
 public:
@@ -69,6 +70,21 @@ public:
 	 */
 	static bool is_control_tank(std::string const &arg);
 	static bool is_control_delta(std::string const &arg);
+	/**
+	 * @brief determines if a signal type of the receiver is to be set and if which one
+	 */
+	static bool is_input_mode(std::string const &arg, E_INPUT_MODE *value);
+	/**
+	 * @brief determines if an input timeout is to be set and if which value
+	 */
+	static bool is_input_timeout(std::string const &arg, size_t *value);
+	/**
+	 * @brief determines if a limit of the pulse validation (width in us, frame period in ms) is to be set and if which value
+	 */
+	static bool is_pulse_width_min(std::string const &arg, size_t *value);
+	static bool is_pulse_width_max(std::string const &arg, size_t *value);
+	static bool is_frame_period_min(std::string const &arg, size_t *value);
+	static bool is_frame_period_max(std::string const &arg, size_t *value);
 	/**
 	 * @brief determines if a deadzone is to be set and if which value
 	 */
@@ -80,6 +96,45 @@ public:
 	static bool is_rc_ch1_max(std::string const &arg, size_t *value);
 	static bool is_rc_ch2_min(std::string const &arg, size_t *value);
 	static bool is_rc_ch2_max(std::string const &arg, size_t *value);
+	/**
+	 * @brief determines if a filter kernel for ch x is to be set and if which one with which parameter
+	 */
+	static bool is_filter_ch1(std::string const &arg, E_FILTER_KERNEL *kernel, size_t *param);
+	static bool is_filter_ch2(std::string const &arg, E_FILTER_KERNEL *kernel, size_t *param);
+	/**
+	 * @brief determines if a pwm frequency is to be set and if which value
+	 */
+	static bool is_pwm_frequency(std::string const &arg, E_PWM_FREQUENCY *value);
+	/**
+	 * @brief determines the phase relation of the pwm of both motors
+	 */
+	static bool is_pwm_in_phase(std::string const &arg);
+	static bool is_pwm_interleaved(std::string const &arg);
+	/**
+	 * @brief determines if the dithering of the pwm duty cycle is to be switched on or off
+	 */
+	static bool is_pwm_dithering_on(std::string const &arg);
+	static bool is_pwm_dithering_off(std::string const &arg);
+	/**
+	 * @brief determines if the aux output is to be driven by a receiver channel and if by which one or if it is to be switched off
+	 */
+	static bool is_aux_channel(std::string const &arg, size_t *value);
+	static bool is_aux_off(std::string const &arg);
+	/**
+	 * @brief determines if a drive mode for the left/right motor is to be set and if which one
+	 */
+	static bool is_drive_mode_left(std::string const &arg, E_DRIVE_MODE *value);
+	static bool is_drive_mode_right(std::string const &arg, E_DRIVE_MODE *value);
+	/**
+	 * @brief determines if a reversal dead time is to be set and if which value
+	 */
+	static bool is_dead_time(std::string const &arg, size_t *value);
+	/**
+	 * @brief determines if a acceleration/deceleration/reversal slew rate is to be set and if which value
+	 */
+	static bool is_accel_rate(std::string const &arg, size_t *value);
+	static bool is_decel_rate(std::string const &arg, size_t *value);
+	static bool is_reversal_rate(std::string const &arg, size_t *value);
 
 private:
 	std::queue<std::string> m_args;
@@ -89,6 +144,26 @@ private:
 	 * @brief converts the float value provided in the -ch1-min-value arguments to size_t which we need for configuration
 	 */
 	static size_t util_convert_from_ms_rc_min_max(float const value);
+
+	/**
+	 * @brief converts the mode name of the -drive-mode-left/right- arguments to the drive mode, returns false if the argument does not start with prefix
+	 */
+	static bool util_convert_drive_mode(std::string const &arg, std::string const &prefix, E_DRIVE_MODE *value);
+
+	/**
+	 * @brief converts the kernel and its parameter of the -filter-ch1/ch2- arguments, returns false if the argument does not start with prefix
+	 */
+	static bool util_convert_filter(std::string const &arg, std::string const &prefix, E_FILTER_KERNEL *kernel, size_t *param);
+
+	/**
+	 * @brief converts the value of the -accel/decel/reversal-rate arguments, returns false if the argument is not rate_arg
+	 */
+	static bool util_convert_rate(std::string const &arg, std::string const &rate_arg, size_t *value);
+
+	/**
+	 * @brief converts the integer value of the argument value_arg within min - max, returns false if the argument is not value_arg
+	 */
+	static bool util_convert_value(std::string const &arg, std::string const &value_arg, unsigned int const min, unsigned int const max, size_t *value);
 };
 
 
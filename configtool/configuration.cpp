@@ -44,14 +44,37 @@ configuration::configuration() {
  */
 void configuration::write() {
 	// send the configuration data to the device
-	size_t const write_request_size = 7 + 3 * sizeof(int); // sizeof(int) = 4; 7 + 3 * 4 = 19
+	size_t const write_request_size = 7 + 3 * sizeof(int) + 23; // sizeof(int) = 4; 7 + 3 * 4 + 23 = 42
 	unsigned char write_request_buf[write_request_size] = {0x01, 0x00,
 			static_cast<unsigned char>(m_conf.deadzone),
 			static_cast<unsigned char>(m_conf.remote_control_min_value_ch1),
 			static_cast<unsigned char>(m_conf.remote_control_max_value_ch1),
 			static_cast<unsigned char>(m_conf.remote_control_min_value_ch2),
 			static_cast<unsigned char>(m_conf.remote_control_max_value_ch2),
-			0,0,0,0,0,0,0,0,0,0,0,0};
+			0,0,0,0,0,0,0,0,0,0,0,0,
+			static_cast<unsigned char>(m_conf.pwm_frequency),
+			static_cast<unsigned char>(m_conf.drive_mode_left),
+			static_cast<unsigned char>(m_conf.drive_mode_right),
+			static_cast<unsigned char>(m_conf.reversal_dead_time_us >> 8),
+			static_cast<unsigned char>(m_conf.reversal_dead_time_us),
+			static_cast<unsigned char>(m_conf.accel_rate),
+			static_cast<unsigned char>(m_conf.decel_rate),
+			static_cast<unsigned char>(m_conf.reversal_rate),
+			static_cast<unsigned char>(m_conf.pwm_phase),
+			static_cast<unsigned char>(m_conf.pwm_dithering ? 1 : 0),
+			static_cast<unsigned char>(m_conf.input_mode),
+			static_cast<unsigned char>(m_conf.input_timeout_ms),
+			static_cast<unsigned char>(m_conf.pulse_min_width_us >> 8),
+			static_cast<unsigned char>(m_conf.pulse_min_width_us),
+			static_cast<unsigned char>(m_conf.pulse_max_width_us >> 8),
+			static_cast<unsigned char>(m_conf.pulse_max_width_us),
+			static_cast<unsigned char>(m_conf.frame_period_min_ms),
+			static_cast<unsigned char>(m_conf.frame_period_max_ms),
+			static_cast<unsigned char>(m_conf.filter_kernel_ch1),
+			static_cast<unsigned char>(m_conf.filter_param_ch1),
+			static_cast<unsigned char>(m_conf.filter_kernel_ch2),
+			static_cast<unsigned char>(m_conf.filter_param_ch2),
+			static_cast<unsigned char>(m_conf.aux_channel)};
 
 	if(m_conf.control == TANK) write_request_buf[1] |= 0x02;
 
@@ -87,7 +110,7 @@ void configuration::read() {
 	serial::get_instance().writeToSerial(read_request_buf, read_request_size);
 
 	// read the answer from the device
-	size_t const read_reply_size = 7;
+	size_t const read_reply_size = 46;
 	boost::shared_array<unsigned char> read_reply_buf = serial::get_instance().readFromSerial(read_reply_size);
 
 	// interpret the answer
@@ -99,16 +122,112 @@ void configuration::read() {
 	m_conf.remote_control_max_value_ch1 = static_cast<size_t>(read_reply_buf.get()[4]);
 	m_conf.remote_control_min_value_ch2 = static_cast<size_t>(read_reply_buf.get()[5]);
 	m_conf.remote_control_max_value_ch2 = static_cast<size_t>(read_reply_buf.get()[6]);
+	m_conf.pwm_frequency = static_cast<E_PWM_FREQUENCY>(read_reply_buf.get()[7]);
+	m_conf.pwm_cpu_load = static_cast<size_t>(read_reply_buf.get()[8]);
+	m_conf.drive_mode_left = static_cast<E_DRIVE_MODE>(read_reply_buf.get()[9]);
+	m_conf.drive_mode_right = static_cast<E_DRIVE_MODE>(read_reply_buf.get()[10]);
+	m_conf.reversal_dead_time_us = (static_cast<size_t>(read_reply_buf.get()[11]) << 8) + static_cast<size_t>(read_reply_buf.get()[12]);
+	m_conf.accel_rate = static_cast<size_t>(read_reply_buf.get()[13]);
+	m_conf.decel_rate = static_cast<size_t>(read_reply_buf.get()[14]);
+	m_conf.reversal_rate = static_cast<size_t>(read_reply_buf.get()[15]);
+	m_conf.pwm_phase = static_cast<E_PWM_PHASE>(read_reply_buf.get()[16]);
+	m_conf.pwm_dithering = (read_reply_buf.get()[17] != 0);
+	m_conf.input_mode = static_cast<E_INPUT_MODE>(read_reply_buf.get()[18]);
+	m_conf.input_frame_rate = (static_cast<size_t>(read_reply_buf.get()[19]) << 8) + static_cast<size_t>(read_reply_buf.get()[20]);
+	m_conf.input_frame_errors = (static_cast<size_t>(read_reply_buf.get()[21]) << 8) + static_cast<size_t>(read_reply_buf.get()[22]);
+	m_conf.input_line_errors = (static_cast<size_t>(read_reply_buf.get()[23]) << 8) + static_cast<size_t>(read_reply_buf.get()[24]);
+	m_conf.input_timeout_ms = static_cast<size_t>(read_reply_buf.get()[25]);
+	m_conf.failsafe_latency_ms = (static_cast<size_t>(read_reply_buf.get()[26]) << 8) + static_cast<size_t>(read_reply_buf.get()[27]);
+	m_conf.input_ring_overflows = (static_cast<size_t>(read_reply_buf.get()[28]) << 8) + static_cast<size_t>(read_reply_buf.get()[29]);
+	m_conf.pulse_min_width_us = (static_cast<size_t>(read_reply_buf.get()[30]) << 8) + static_cast<size_t>(read_reply_buf.get()[31]);
+	m_conf.pulse_max_width_us = (static_cast<size_t>(read_reply_buf.get()[32]) << 8) + static_cast<size_t>(read_reply_buf.get()[33]);
+	m_conf.frame_period_min_ms = static_cast<size_t>(read_reply_buf.get()[34]);
+	m_conf.frame_period_max_ms = static_cast<size_t>(read_reply_buf.get()[35]);
+	m_conf.rejected_pulses_ch1 = (static_cast<size_t>(read_reply_buf.get()[36]) << 8) + static_cast<size_t>(read_reply_buf.get()[37]);
+	m_conf.rejected_pulses_ch2 = (static_cast<size_t>(read_reply_buf.get()[38]) << 8) + static_cast<size_t>(read_reply_buf.get()[39]);
+	m_conf.input_mode_detected = static_cast<E_INPUT_MODE>(read_reply_buf.get()[40]);
+	m_conf.filter_kernel_ch1 = static_cast<E_FILTER_KERNEL>(read_reply_buf.get()[41]);
+	m_conf.filter_param_ch1 = static_cast<size_t>(read_reply_buf.get()[42]);
+	m_conf.filter_kernel_ch2 = static_cast<E_FILTER_KERNEL>(read_reply_buf.get()[43]);
+	m_conf.filter_param_ch2 = static_cast<size_t>(read_reply_buf.get()[44]);
+	m_conf.aux_channel = static_cast<size_t>(read_reply_buf.get()[45]);
 
 	// calculate the r-s-t values in case we write them dowm to the device again if this is a write command
 	update();
 }
 
+/**
+ * @brief returns the name of a drive mode for displaying it to the user
+ */
+static char const *drive_mode_to_string(E_DRIVE_MODE const mode) {
+	switch(mode) {
+	case COAST: return "COAST";
+	case BRAKE: return "BRAKE";
+	case DRIVE_BRAKE: return "DRIVE-BRAKE";
+	default: return "unknown";
+	}
+}
+
+/**
+ * @brief returns the name and wiring of an input mode for displaying it to the user
+ */
+static char const *input_mode_to_string(E_INPUT_MODE const mode) {
+	switch(mode) {
+	case INPUT_PWM: return "PWM (CH1 and CH2 on separate pins)";
+	case INPUT_PPM: return "PPM (sum signal on the CH1 pin)";
+	case INPUT_SBUS: return "SBUS (inverted, on RXD1/PD2)";
+	case INPUT_IBUS: return "IBUS (on RXD1/PD2)";
+	case INPUT_CRSF: return "CRSF (400000 baud, on RXD1/PD2)";
+	case INPUT_ONESHOT125: return "ONESHOT125 (125 - 250 us, CH1 and CH2 on separate pins)";
+	case INPUT_ONESHOT42: return "ONESHOT42 (42 - 84 us, CH1 and CH2 on separate pins)";
+	case INPUT_MULTISHOT: return "MULTISHOT (5 - 25 us, CH1 and CH2 on separate pins)";
+	case INPUT_DSHOT150: return "DSHOT150 (3D mode, CH1 and CH2 on separate pins)";
+	default: return "unknown";
+	}
+}
+
+/**
+ * @brief writes the filter kernel of a channel and its parameter for displaying it to the user
+ */
+static void print_filter(std::ostream &os, E_FILTER_KERNEL const kernel, size_t const param) {
+	os << "Filter = ";
+	switch(kernel) {
+	case FILTER_AVERAGE: os << "AVERAGE of " << param << " values"; break;
+	case FILTER_MEDIAN: os << "MEDIAN of " << param << " values"; break;
+	case FILTER_IIR: os << "IIR, new value weighted " << param << "/256"; break;
+	case FILTER_BYPASS: os << "BYPASS"; break;
+	case FILTER_ADAPTIVE: os << "ADAPTIVE, changes of " << param * 4 << " us and more pass at once"; break;
+	default: os << "unknown"; break;
+	}
+	os << std::endl;
+}
+
 /**
  * @brief writes the configuration in a output stream for displaying it to the user
  */
 std::ostream &operator<<(std::ostream& os, configuration &c) {
 	os << "LXRobotics Antweight Electronic Speed Controller Configuration:" << std::endl;
+	os << "Input = ";
+	// with auto detection the statistics belong to the detected input
+	E_INPUT_MODE input_mode = c.m_conf.input_mode;
+	if(input_mode == INPUT_AUTO) {
+		input_mode = c.m_conf.input_mode_detected;
+		os << "AUTO, detected ";
+		if(input_mode == INPUT_AUTO) os << "nothing yet";
+	}
+	if(input_mode != INPUT_AUTO) os << input_mode_to_string(input_mode);
+	os << std::endl;
+	if(input_mode == INPUT_SBUS || input_mode == INPUT_IBUS || input_mode == INPUT_CRSF) {
+		os << "Frame Rate = " << c.m_conf.input_frame_rate << " /s, Frame Errors = " << c.m_conf.input_frame_errors << ", Line Errors = " << c.m_conf.input_line_errors << std::endl;
+	} else if(input_mode == INPUT_DSHOT150) {
+		os << "Frame Rate (CH1) = " << c.m_conf.input_frame_rate << " /s, CRC Errors = " << c.m_conf.input_frame_errors << ", Sample Ring Overflows = " << c.m_conf.input_ring_overflows << std::endl;
+	} else if(input_mode == INPUT_ONESHOT125 || input_mode == INPUT_ONESHOT42 || input_mode == INPUT_MULTISHOT) {
+		os << "Pulse Rate (CH1) = " << c.m_conf.input_frame_rate << " /s, Out Of Range CH1 = " << c.m_conf.rejected_pulses_ch1 << ", CH2 = " << c.m_conf.rejected_pulses_ch2 << ", Sample Ring Overflows = " << c.m_conf.input_ring_overflows << std::endl;
+	} else {
+		os << "Pulse Rate (CH1) = " << c.m_conf.input_frame_rate << " /s, Sample Ring Overflows = " << c.m_conf.input_ring_overflows << std::endl;
+	}
+	os << "Pulse Validation = " << c.m_conf.pulse_min_width_us << " - " << c.m_conf.pulse_max_width_us << " us, frame period " << c.m_conf.frame_period_min_ms << " - " << c.m_conf.frame_period_max_ms << " ms (rejected CH1 = " << c.m_conf.rejected_pulses_ch1 << ", CH2 = " << c.m_conf.rejected_pulses_ch2 << ")" << std::endl;
+	os << "Input Timeout = " << c.m_conf.input_timeout_ms << " ms (last signal loss detected after " << c.m_conf.failsafe_latency_ms << " ms)" << std::endl;
 	os << "Control Method = ";
 	if(c.m_conf.control == TANK) os << "TANK" << std::endl;
 	else os << "DELTA" << std::endl;
@@ -116,12 +235,41 @@ std::ostream &operator<<(std::ostream& os, configuration &c) {
 	os << "CH1:" << std::endl << std::setprecision(2) << std::fixed;
 	os << "Remote Control Min Value = " << static_cast<float>(c.m_conf.remote_control_min_value_ch1) / 250.0f + 1.0f << std::endl;
 	os << "Remote Control Max Value = " << static_cast<float>(c.m_conf.remote_control_max_value_ch1) / 250.0f + 1.0f << std::endl;
+	print_filter(os, c.m_conf.filter_kernel_ch1, c.m_conf.filter_param_ch1);
 	os << "CH2:" << std::endl;
 	os << "Remote Control Min Value = " << static_cast<float>(c.m_conf.remote_control_min_value_ch2) / 250.0f + 1.0f << std::endl;
 	os << "Remote Control Max Value = " << static_cast<float>(c.m_conf.remote_control_max_value_ch2) / 250.0f + 1.0f << std::endl;
+	print_filter(os, c.m_conf.filter_kernel_ch2, c.m_conf.filter_param_ch2);
+	os << "PWM Frequency = ";
+	switch(c.m_conf.pwm_frequency) {
+	case PWM_1KHZ: os << "1 kHz"; break;
+	case PWM_4KHZ: os << "4 kHz"; break;
+	case PWM_8KHZ: os << "8 kHz"; break;
+	case PWM_16KHZ: os << "16 kHz"; break;
+	case PWM_20KHZ: os << "20 kHz"; break;
+	default: os << "unknown"; break;
+	}
+	os << " (estimated PWM interrupt load " << c.m_conf.pwm_cpu_load << " %)" << std::endl;
+	os << "PWM Phase = ";
+	if(c.m_conf.pwm_phase == PWM_INTERLEAVED) os << "INTERLEAVED" << std::endl;
+	else os << "IN PHASE" << std::endl;
+	os << "PWM Dithering = ";
+	if(c.m_conf.pwm_dithering) os << "ON" << std::endl;
+	else os << "OFF" << std::endl;
+	os << "Aux Output (PD7) = ";
+	if(c.m_conf.aux_channel == 0) os << "OFF" << std::endl;
+	else os << "CH " << c.m_conf.aux_channel << std::endl;
+	os << "Drive Mode Left = " << drive_mode_to_string(c.m_conf.drive_mode_left) << std::endl;
+	os << "Drive Mode Right = " << drive_mode_to_string(c.m_conf.drive_mode_right) << std::endl;
+	os << "Reversal Dead Time = " << c.m_conf.reversal_dead_time_us << " us" << std::endl;
+	os << "Slew Rates (speed steps of 255 per ms, 0 = unlimited):" << std::endl;
+	os << "Acceleration = " << c.m_conf.accel_rate << std::endl;
+	os << "Deceleration = " << c.m_conf.decel_rate << std::endl;
+	os << "Reversal = " << c.m_conf.reversal_rate << std::endl;
 	return os;
 }
 
+
 /**
  * @brief update function for updating the r-s-t values for left and right channel delta control
  */
@@ -31,6 +31,11 @@
 #include "dim3.h"
 
 enum E_CONTROL{TANK, DELTA};
+enum E_PWM_FREQUENCY{PWM_1KHZ, PWM_4KHZ, PWM_8KHZ, PWM_16KHZ, PWM_20KHZ};
+enum E_PWM_PHASE{PWM_IN_PHASE, PWM_INTERLEAVED};
+enum E_DRIVE_MODE{COAST, BRAKE, DRIVE_BRAKE};
+enum E_INPUT_MODE{INPUT_PWM, INPUT_PPM, INPUT_SBUS, INPUT_IBUS, INPUT_CRSF, INPUT_ONESHOT125, INPUT_ONESHOT42, INPUT_MULTISHOT, INPUT_DSHOT150, INPUT_AUTO};
+enum E_FILTER_KERNEL{FILTER_AVERAGE, FILTER_MEDIAN, FILTER_IIR, FILTER_BYPASS, FILTER_ADAPTIVE};
 
 typedef struct {
 	E_CONTROL control;
@@ -41,6 +46,35 @@ typedef struct {
 	size_t remote_control_max_value_ch2;
 	int r1, s1, t1;
 	int r2, s2, t2;
+	E_PWM_FREQUENCY pwm_frequency;
+	size_t pwm_cpu_load; // estimated load of the pwm interrupt in percent, read only
+	E_DRIVE_MODE drive_mode_left;
+	E_DRIVE_MODE drive_mode_right;
+	size_t reversal_dead_time_us;
+	size_t accel_rate; // maximum change of the motor speed (0 - 255) per ms, 0 = unlimited
+	size_t decel_rate;
+	size_t reversal_rate;
+	E_PWM_PHASE pwm_phase; // in phase or right motor shifted by half a period
+	bool pwm_dithering; // spread the fractional part of the duty cycle over successive pwm periods
+	E_INPUT_MODE input_mode; // signal type of the receiver, INPUT_AUTO = detected at boot
+	E_INPUT_MODE input_mode_detected; // signal type found by the last detection at boot (INPUT_AUTO = none), read only
+	size_t input_frame_rate; // valid frames per second of the serial protocols, read only
+	size_t input_frame_errors; // frames with a wrong checksum or crc, read only
+	size_t input_line_errors; // bytes with framing, parity or overrun errors or lost bytes, read only
+	size_t input_timeout_ms; // a channel without a pulse for that time is lost and the motors are switched off
+	size_t failsafe_latency_ms; // time from the last pulse to the detection of the last signal loss, read only
+	size_t input_ring_overflows; // samples of the edge interrupts dropped since the main loop did not take them in time, read only
+	size_t pulse_min_width_us; // shorter pwm pulses and ppm channels are rejected
+	size_t pulse_max_width_us; // longer pwm pulses and ppm channels are rejected
+	size_t frame_period_min_ms; // a pwm pulse closer to the previous one is rejected
+	size_t frame_period_max_ms; // a pwm pulse after a longer pause only starts the period measurement again
+	size_t rejected_pulses_ch1; // pulses rejected by the validation, read only
+	size_t rejected_pulses_ch2;
+	E_FILTER_KERNEL filter_kernel_ch1; // filter of the input values of ch 1
+	size_t filter_param_ch1; // number of values (average 1 - 16, median 3 or 5), weight of a new value in 1 / 256 (iir 1 - 255) or change in 4 us which passes at once (adaptive 1 - 255)
+	E_FILTER_KERNEL filter_kernel_ch2;
+	size_t filter_param_ch2;
+	size_t aux_channel; // receiver channel (1 - 16) driving the aux output on PD7, 0 = aux output off
 } s_configuration;
 
 class configuration {
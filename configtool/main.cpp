@@ -36,6 +36,21 @@ void print_help() {
 	std::cout << "\tDEVICE_NODE\tname of the serial port occupied by the device,\n\t\t\te.g. COM3 in Windows or /dev/ttyACM0 in Linux" << std::endl;
 	std::cout << "\t-help\t\tget this help file" << std::endl;
 	std::cout << "\t-display\tshows the current configuration of the speed controller" << std::endl;
+	std::cout << "\t-input-pwm\tread one servo pulse per channel, ch 1 and ch 2 on separate pins" << std::endl;
+	std::cout << "\t-input-ppm\tread a ppm sum signal (up to 8 channels) on the ch 1 pin, ch 1 and ch 2 of the frame are used" << std::endl;
+	std::cout << "\t-input-sbus\tread sbus frames (inverted by hardware) on RXD1 (PD2), ch 1 and ch 2 of the frame are used" << std::endl;
+	std::cout << "\t-input-ibus\tread ibus frames on RXD1 (PD2), ch 1 and ch 2 of the frame are used" << std::endl;
+	std::cout << "\t-input-crsf\tread crsf frames at 400000 baud on RXD1 (PD2), ch 1 and ch 2 of the frame are used" << std::endl;
+	std::cout << "\t-input-oneshot125\tread oneshot125 pulses (125 - 250 us, up to 4 kHz) on the ch 1 and ch 2 pins" << std::endl;
+	std::cout << "\t-input-oneshot42\tread oneshot42 pulses (42 - 84 us, up to 8 kHz) on the ch 1 and ch 2 pins" << std::endl;
+	std::cout << "\t-input-multishot\tread multishot pulses (5 - 25 us, up to 8 kHz) on the ch 1 and ch 2 pins" << std::endl;
+	std::cout << "\t-input-dshot150\tread crc checked dshot150 frames (3d mode) on the ch 1 and ch 2 pins, no calibration of the neutral position, pwm frequency up to 8 kHz" << std::endl;
+	std::cout << "\t-input-auto\tdetect the input at boot (within 200 ms), the detected input is tried first at the next boot" << std::endl;
+	std::cout << "\t-input-timeout-VALUE\tswitch the motors off if a channel had no pulse for VALUE ms (20 - 255, e.g. 60 = 3 frames of 20 ms)" << std::endl;
+	std::cout << "\t-pulse-width-min-VALUE\treject pwm pulses and ppm channels shorter than VALUE us (500 - 2500)" << std::endl;
+	std::cout << "\t-pulse-width-max-VALUE\treject pwm pulses and ppm channels longer than VALUE us (500 - 2500)" << std::endl;
+	std::cout << "\t-frame-period-min-VALUE\treject pwm pulses closer than VALUE ms to the previous one (2 - 255)" << std::endl;
+	std::cout << "\t-frame-period-max-VALUE\tdo not pass on a pwm pulse after a pause longer than VALUE ms (2 - 255)" << std::endl;
 	std::cout << "\t-control-tank\tset control method to tank steering" << std::endl;
 	std::cout << "\t-control-delta\tset control method to delta steering" << std::endl;
 	std::cout << "\t-deadzone-VALUE\tset the deadzone value to the value VALUE (around 0.1 ms)" << std::endl;
@@ -43,6 +58,21 @@ void print_help() {
 	std::cout << "\t-ch1-max-value-VALUE\tset the maximum value of the remote control of ch 1 (around 2.0 ms)" << std::endl;
 	std::cout << "\t-ch2-min-value-VALUE\tset the minimum value of the remote control of ch 2 (around 1.0 ms)" << std::endl;
 	std::cout << "\t-ch2-max-value-VALUE\tset the maximum value of the remote control of ch 2 (around 2.0 ms)" << std::endl;
+	std::cout << "\t-filter-ch1-KERNEL\tset the filter of ch 1: average-N (moving average of N = 1 - 16 values), median-3 or median-5 (removes spikes), iir-N (low pass, new value weighted N/256, N = 1 - 255), adaptive-N (low pass for small changes, changes of N * 4 us and more pass at once, N = 1 - 255, e.g. 25) or bypass" << std::endl;
+	std::cout << "\t-filter-ch2-KERNEL\tset the filter of ch 2, see -filter-ch1-KERNEL" << std::endl;
+	std::cout << "\t-pwm-frequency-VALUE\tset the pwm frequency of the motors in kHz (1, 4, 8, 16 or 20)" << std::endl;
+	std::cout << "\t-pwm-in-phase\tswitch both motors on at the start of the pwm period" << std::endl;
+	std::cout << "\t-pwm-interleaved\tswitch the right motor on half a pwm period after the left one for a smoother supply current (not with 20 kHz)" << std::endl;
+	std::cout << "\t-pwm-dithering-on\tspread the fractional part of the duty cycle over successive pwm periods for a finer speed resolution (not with 20 kHz or 16 kHz interleaved)" << std::endl;
+	std::cout << "\t-pwm-dithering-off\tround the duty cycle to whole timer ticks" << std::endl;
+	std::cout << "\t-aux-channel-VALUE\tdrive the aux output (PD7) with ch VALUE of a ppm, sbus, ibus or crsf frame (1 - 16), 1.0 - 2.0 ms = 0 - 100 % duty cycle, adds pwm interrupt load (not with 16 kHz or 20 kHz)" << std::endl;
+	std::cout << "\t-aux-off\tswitch the aux output off" << std::endl;
+	std::cout << "\t-drive-mode-left-MODE\tset the drive mode of the left motor (coast, brake or drive-brake: braked during the pwm off time, released at zero speed)" << std::endl;
+	std::cout << "\t-drive-mode-right-MODE\tset the drive mode of the right motor (coast, brake or drive-brake: braked during the pwm off time, released at zero speed)" << std::endl;
+	std::cout << "\t-dead-time-VALUE\tset the time in us a motor is not driven before it reverses (0 - 5000)" << std::endl;
+	std::cout << "\t-accel-rate-VALUE\tset the maximum speed increase per ms (0 - 255 of full speed 255, 0 = unlimited)" << std::endl;
+	std::cout << "\t-decel-rate-VALUE\tset the maximum speed decrease per ms (0 - 255 of full speed 255, 0 = unlimited)" << std::endl;
+	std::cout << "\t-reversal-rate-VALUE\tset the maximum speed change per ms when reversing (0 - 255 of full speed 255, 0 = unlimited)" << std::endl;
 }
 
 
@@ -61,10 +91,26 @@ void checked_main(int const argc, char **argv) {
 
 		size_t deadzone = 0;
 		size_t rc_val = 0;
+		E_PWM_FREQUENCY pwm_frequency = PWM_1KHZ;
+		E_DRIVE_MODE drive_mode = COAST;
+		E_INPUT_MODE input_mode = INPUT_PWM;
+		size_t dead_time = 0;
+		size_t rate = 0;
+		size_t input_timeout = 0;
+		size_t limit = 0;
+		E_FILTER_KERNEL filter_kernel = FILTER_AVERAGE;
+		size_t filter_param = 0;
+		size_t aux_channel = 0;
 		if(args::is_help(arg)) {
 			print_help();
 			throw std::runtime_error("Hopefully the help helped you. Exiting program.");
 		}
+		else if(args::is_input_timeout(arg, &input_timeout)) conf.get()->input_timeout_ms = input_timeout;
+		else if(args::is_pulse_width_min(arg, &limit)) conf.get()->pulse_min_width_us = limit;
+		else if(args::is_pulse_width_max(arg, &limit)) conf.get()->pulse_max_width_us = limit;
+		else if(args::is_frame_period_min(arg, &limit)) conf.get()->frame_period_min_ms = limit;
+		else if(args::is_frame_period_max(arg, &limit)) conf.get()->frame_period_max_ms = limit;
+		else if(args::is_input_mode(arg, &input_mode)) conf.get()->input_mode = input_mode;
 		else if(args::is_control_tank(arg)) conf.get()->control = TANK;
 		else if(args::is_control_delta(arg)) conf.get()->control = DELTA;
 		else if(args::is_deadzone(arg, &deadzone)) conf.get()->deadzone = deadzone;
@@ -84,6 +130,27 @@ void checked_main(int const argc, char **argv) {
 			conf.get()->remote_control_max_value_ch2 = rc_val;
 			conf.update();
 		}
+		else if(args::is_filter_ch1(arg, &filter_kernel, &filter_param)) {
+			conf.get()->filter_kernel_ch1 = filter_kernel;
+			conf.get()->filter_param_ch1 = filter_param;
+		}
+		else if(args::is_filter_ch2(arg, &filter_kernel, &filter_param)) {
+			conf.get()->filter_kernel_ch2 = filter_kernel;
+			conf.get()->filter_param_ch2 = filter_param;
+		}
+		else if(args::is_pwm_frequency(arg, &pwm_frequency)) conf.get()->pwm_frequency = pwm_frequency;
+		else if(args::is_pwm_in_phase(arg)) conf.get()->pwm_phase = PWM_IN_PHASE;
+		else if(args::is_pwm_interleaved(arg)) conf.get()->pwm_phase = PWM_INTERLEAVED;
+		else if(args::is_pwm_dithering_on(arg)) conf.get()->pwm_dithering = true;
+		else if(args::is_pwm_dithering_off(arg)) conf.get()->pwm_dithering = false;
+		else if(args::is_aux_channel(arg, &aux_channel)) conf.get()->aux_channel = aux_channel;
+		else if(args::is_aux_off(arg)) conf.get()->aux_channel = 0;
+		else if(args::is_drive_mode_left(arg, &drive_mode)) conf.get()->drive_mode_left = drive_mode;
+		else if(args::is_drive_mode_right(arg, &drive_mode)) conf.get()->drive_mode_right = drive_mode;
+		else if(args::is_dead_time(arg, &dead_time)) conf.get()->reversal_dead_time_us = dead_time;
+		else if(args::is_accel_rate(arg, &rate)) conf.get()->accel_rate = rate;
+		else if(args::is_decel_rate(arg, &rate)) conf.get()->decel_rate = rate;
+		else if(args::is_reversal_rate(arg, &rate)) conf.get()->reversal_rate = rate;
 		else if(args::is_display_configuration(arg)) display_configuration = true;
 		else throw std::runtime_error("Argument not valid. Exiting program.");
 	}
@@ -6,10 +6,18 @@ config.c
 
 control.c
 
+crsf.c
+
+dshot.c
+
 filter.c
 
+ibus.c
+
 input.c
 
+input_detect.c
+
 linear_mapper.c
 
 linear_mapper_2d.c
@@ -142,8 +150,18 @@ main.c
 
 motor_control.c
 
+sbus.c
+
+serial_decoder.c
+
+serial_rx.c
+
+slew_limiter.c
+
 status_led.c
 
+timebase.c
+
 VirtualSerial\Descriptors.c
 
 VirtualSerial\VirtualSerial.c
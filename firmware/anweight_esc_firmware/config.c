@@ -28,8 +28,7 @@
 #include <avr/eeprom.h>
 
 #define CONFIG_EEPROM_ADDRESS	(const void*)(0)
-#define EEPROM_WRITTEN			(0x00)
-#define EEPROM_NOT_WRITTEN		(0xFF)
+#define EEPROM_WRITTEN			(0x0C) // incremented with every change of the layout of s_config_data
 
 /**
  * @brief initializes the configuration data
@@ -37,7 +36,7 @@
 void init_config() {
 	// load from EEPROM
 	eeprom_read_block((void*)(&configuration), CONFIG_EEPROM_ADDRESS, sizeof(configuration));
-	if(configuration.eeprom_written == EEPROM_NOT_WRITTEN) { // device was previously not configured, setting to standard values
+	if(configuration.eeprom_written != EEPROM_WRITTEN) { // device was previously not configured or with an older layout, setting to standard values
 		configuration.eeprom_written = EEPROM_WRITTEN;
 		configuration.control = TANK;
 		configuration.deadzone = 20;
@@ -45,6 +44,27 @@ void init_config() {
 		configuration.remote_control_max_value_ch_1 = 250;
 		configuration.remote_control_min_value_ch_2 = 0;
 		configuration.remote_control_max_value_ch_2 = 250;
+		configuration.pwm_frequency = PWM_1KHZ;
+		configuration.pwm_phase = PWM_IN_PHASE;
+		configuration.pwm_dithering = false;
+		configuration.drive_mode_motor_left = COAST;
+		configuration.drive_mode_motor_right = COAST;
+		configuration.reversal_dead_time_us = 200;
+		configuration.accel_rate = 2; // 0 to full speed in 128 ms
+		configuration.decel_rate = 4;
+		configuration.reversal_rate = 2;
+		configuration.input_mode = INPUT_AUTO;
+		configuration.input_mode_detected = INPUT_AUTO;
+		configuration.input_timeout_ms = INPUT_DEFAULT_TIMEOUT_MS;
+		configuration.pulse_min_width_us = INPUT_DEFAULT_MIN_WIDTH_US;
+		configuration.pulse_max_width_us = INPUT_DEFAULT_MAX_WIDTH_US;
+		configuration.frame_period_min_ms = INPUT_DEFAULT_MIN_PERIOD_MS;
+		configuration.frame_period_max_ms = INPUT_DEFAULT_MAX_PERIOD_MS;
+		configuration.filter_kernel_ch_1 = FILTER_AVERAGE;
+		configuration.filter_param_ch_1 = 4;
+		configuration.filter_kernel_ch_2 = FILTER_AVERAGE;
+		configuration.filter_param_ch_2 = 4;
+		configuration.aux_channel = 0;
 		eeprom_write_block((void*)(&configuration), CONFIG_EEPROM_ADDRESS, sizeof(configuration));
 	}
 }
@@ -59,6 +79,30 @@ void init_config() {
 #define S_WRITE_R1			(7)
 #define S_WRITE_R2			(8)
 #define S_WRITE_S1			(9)
+#define S_WRITE_PWM_FREQ	(10)
+#define S_WRITE_DRIVE_MODE_LEFT		(11)
+#define S_WRITE_DRIVE_MODE_RIGHT	(12)
+#define S_WRITE_DEAD_TIME_HIGH		(13)
+#define S_WRITE_DEAD_TIME_LOW		(14)
+#define S_WRITE_ACCEL_RATE			(15)
+#define S_WRITE_DECEL_RATE			(16)
+#define S_WRITE_REVERSAL_RATE		(17)
+#define S_WRITE_PWM_PHASE			(18)
+#define S_WRITE_PWM_DITHERING		(19)
+#define S_WRITE_INPUT_MODE			(20)
+#define S_WRITE_INPUT_TIMEOUT		(21)
+#define S_WRITE_MIN_WIDTH_HIGH		(22)
+#define S_WRITE_MIN_WIDTH_LOW		(23)
+#define S_WRITE_MAX_WIDTH_HIGH		(24)
+#define S_WRITE_MAX_WIDTH_LOW		(25)
+#define S_WRITE_MIN_PERIOD			(26)
+#define S_WRITE_MAX_PERIOD			(27)
+#define S_WRITE_FILTER_KERNEL_CH1	(28)
+#define S_WRITE_FILTER_PARAM_CH1	(29)
+#define S_WRITE_FILTER_KERNEL_CH2	(30)
+#define S_WRITE_FILTER_PARAM_CH2	(31)
+#define S_WRITE_AUX_CHANNEL			(32)
+#define S_WRITE_LAST				(S_WRITE_AUX_CHANNEL)
 
 #define	S_REQUEST_KIND_READ			(0x00)
 #define	S_REQUEST_KIND_WRITE		(0x01)
@@ -69,6 +113,14 @@ void init_config() {
 #define MSG_NOK			(0x00)
 
 static uint8_t config_parse_state = S_REQUEST_KIND;
+static volatile uint8_t msg[S_WRITE_LAST + 1];
+static uint8_t r1[4] = {0}, r2[4] = {0}, s1[4] = {0};
+
+/**
+ * @brief applies a completely received write request to the configuration and stores it in the eeprom
+ */
+static void config_write(bool *config_done_ptr);
+
 /** 
  * @brief parses the incoming data on the serial usb device
  * @param data_byte received byte from the serial usb device
@@ -76,8 +128,6 @@ static uint8_t config_parse_state = S_REQUEST_KIND;
  */
 void config_parse_data(uint8_t const data_byte, bool *config_done_ptr) {
 	
-	static volatile uint8_t msg[7 + 3 * sizeof(uint32_t)];
-	static uint8_t r1[4] = {0}, r2[4] = {0}, s1[4] = {0};
 	static uint8_t byte_cnt = 0; // used for receiving the 4 byte integers for R-S-T
 	
 	switch(config_parse_state) {
@@ -87,7 +137,9 @@ void config_parse_data(uint8_t const data_byte, bool *config_done_ptr) {
 				// configuration is now done here
 				*config_done_ptr = true;
 				// generate read reply message
-				uint8_t msg_reply[7] = {0x00};
+				uint8_t msg_reply[46] = {0x00};
+				input_stats stats;
+				input_get_stats(&stats);
 				msg_reply[0] = MSG_OK;
 				if(configuration.control == TANK) msg_reply[1] |= S_CONFIG_CONTROL_MASK;
 				msg_reply[2] = configuration.deadzone;
@@ -95,8 +147,48 @@ void config_parse_data(uint8_t const data_byte, bool *config_done_ptr) {
 				msg_reply[4] = configuration.remote_control_max_value_ch_1;
 				msg_reply[5] = configuration.remote_control_min_value_ch_2;
 				msg_reply[6] = configuration.remote_control_max_value_ch_2;
+				msg_reply[7] = configuration.pwm_frequency;
+				msg_reply[8] = (uint8_t)(pwm_cpu_load(configuration.pwm_frequency, configuration.pwm_phase, configuration.pwm_dithering, configuration.aux_channel != 0) / 10); // estimated load of the pwm interrupt in percent
+				msg_reply[9] = configuration.drive_mode_motor_left;
+				msg_reply[10] = configuration.drive_mode_motor_right;
+				msg_reply[11] = (uint8_t)(configuration.reversal_dead_time_us >> 8);
+				msg_reply[12] = (uint8_t)(configuration.reversal_dead_time_us);
+				msg_reply[13] = configuration.accel_rate;
+				msg_reply[14] = configuration.decel_rate;
+				msg_reply[15] = configuration.reversal_rate;
+				msg_reply[16] = configuration.pwm_phase;
+				msg_reply[17] = configuration.pwm_dithering ? 1 : 0;
+				msg_reply[18] = configuration.input_mode;
+				// statistics of the input, received before the configuration started
+				msg_reply[19] = (uint8_t)(stats.frame_rate >> 8);
+				msg_reply[20] = (uint8_t)(stats.frame_rate);
+				msg_reply[21] = (uint8_t)(stats.frame_errors >> 8);
+				msg_reply[22] = (uint8_t)(stats.frame_errors);
+				msg_reply[23] = (uint8_t)(stats.line_errors >> 8);
+				msg_reply[24] = (uint8_t)(stats.line_errors);
+				msg_reply[25] = configuration.input_timeout_ms;
+				msg_reply[26] = (uint8_t)(stats.failsafe_latency_ms >> 8);
+				msg_reply[27] = (uint8_t)(stats.failsafe_latency_ms);
+				msg_reply[28] = (uint8_t)(stats.ring_overflows >> 8);
+				msg_reply[29] = (uint8_t)(stats.ring_overflows);
+				msg_reply[30] = (uint8_t)(configuration.pulse_min_width_us >> 8);
+				msg_reply[31] = (uint8_t)(configuration.pulse_min_width_us);
+				msg_reply[32] = (uint8_t)(configuration.pulse_max_width_us >> 8);
+				msg_reply[33] = (uint8_t)(configuration.pulse_max_width_us);
+				msg_reply[34] = configuration.frame_period_min_ms;
+				msg_reply[35] = configuration.frame_period_max_ms;
+				msg_reply[36] = (uint8_t)(stats.rejected_pulses[0] >> 8);
+				msg_reply[37] = (uint8_t)(stats.rejected_pulses[0]);
+				msg_reply[38] = (uint8_t)(stats.rejected_pulses[1] >> 8);
+				msg_reply[39] = (uint8_t)(stats.rejected_pulses[1]);
+				msg_reply[40] = configuration.input_mode_detected;
+				msg_reply[41] = configuration.filter_kernel_ch_1;
+				msg_reply[42] = configuration.filter_param_ch_1;
+				msg_reply[43] = configuration.filter_kernel_ch_2;
+				msg_reply[44] = configuration.filter_param_ch_2;
+				msg_reply[45] = configuration.aux_channel;
 				// send read reply message
-				virtual_serial_send_data(&msg_reply, 7);					
+				virtual_serial_send_data(&msg_reply, 46);					
 			} else if(msg[S_REQUEST_KIND] == S_REQUEST_KIND_WRITE) {
 				config_parse_state = S_WRITE_CONFIG;
 			}			
@@ -147,42 +239,189 @@ void config_parse_data(uint8_t const data_byte, bool *config_done_ptr) {
 			byte_cnt++;
 			if(byte_cnt == 4) {
 				byte_cnt = 0;
-				
-				config_parse_state = S_REQUEST_KIND;
-				
-				// configuration byte
-				if(msg[S_WRITE_CONFIG] & S_CONFIG_CONTROL_MASK) configuration.control = TANK;
-				else configuration.control = DELTA;
-				// deadzone byte
-				configuration.deadzone = msg[S_WRITE_DEADZONE];
-				// channel 1 min and maximum values
-				configuration.remote_control_min_value_ch_1 = msg[S_WRITE_CH1_MIN];
-				configuration.remote_control_max_value_ch_1 = msg[S_WRITE_CH1_MAX];
-				// channel 2 min and maximum values
-				configuration.remote_control_min_value_ch_2 = msg[S_WRITE_CH2_MIN];
-				configuration.remote_control_max_value_ch_2 = msg[S_WRITE_CH2_MAX];
-				// r - s - t values
-				// channel 1
-				configuration.r1 = (int32_t)(((uint32_t)(r1[0])<<24) + ((uint32_t)(r1[1])<<16) + ((uint32_t)(r1[2])<<8) + ((uint32_t)(r1[3])));
-				configuration.s1 = (int32_t)(((uint32_t)(s1[0])<<24) + ((uint32_t)(s1[1])<<16) + ((uint32_t)(s1[2])<<8) + ((uint32_t)(s1[3])));
-				configuration.t1 = configuration.s1;
-				// channel 2
-				configuration.r2 = (int32_t)(((uint32_t)(r2[0])<<24) + ((uint32_t)(r2[1])<<16) + ((uint32_t)(r2[2])<<8) + ((uint32_t)(r2[3])));
-				configuration.s2 = configuration.s1;
-				configuration.t2 = 0 - configuration.s1; // *(-1)
-				// update the linear mapper 2d
-				update_linear_mapper_2d();
-				// write data to eeprom
-				eeprom_write_block((void*)(&configuration), CONFIG_EEPROM_ADDRESS, sizeof(configuration));
-				// configuration is now done here
-				*config_done_ptr = true;
-				// send answer
-				uint8_t msg_reply = MSG_OK;
-				virtual_serial_send_data(&msg_reply, 1);
+				config_parse_state = S_WRITE_PWM_FREQ;
 			}
 		} break;
+		case S_WRITE_PWM_FREQ: {
+			msg[S_WRITE_PWM_FREQ] = data_byte;
+			config_parse_state = S_WRITE_DRIVE_MODE_LEFT;
+		} break;
+		case S_WRITE_DRIVE_MODE_LEFT: {
+			msg[S_WRITE_DRIVE_MODE_LEFT] = data_byte;
+			config_parse_state = S_WRITE_DRIVE_MODE_RIGHT;
+		} break;
+		case S_WRITE_DRIVE_MODE_RIGHT: {
+			msg[S_WRITE_DRIVE_MODE_RIGHT] = data_byte;
+			config_parse_state = S_WRITE_DEAD_TIME_HIGH;
+		} break;
+		case S_WRITE_DEAD_TIME_HIGH: {
+			msg[S_WRITE_DEAD_TIME_HIGH] = data_byte;
+			config_parse_state = S_WRITE_DEAD_TIME_LOW;
+		} break;
+		case S_WRITE_DEAD_TIME_LOW: {
+			msg[S_WRITE_DEAD_TIME_LOW] = data_byte;
+			config_parse_state = S_WRITE_ACCEL_RATE;
+		} break;
+		case S_WRITE_ACCEL_RATE: {
+			msg[S_WRITE_ACCEL_RATE] = data_byte;
+			config_parse_state = S_WRITE_DECEL_RATE;
+		} break;
+		case S_WRITE_DECEL_RATE: {
+			msg[S_WRITE_DECEL_RATE] = data_byte;
+			config_parse_state = S_WRITE_REVERSAL_RATE;
+		} break;
+		case S_WRITE_REVERSAL_RATE: {
+			msg[S_WRITE_REVERSAL_RATE] = data_byte;
+			config_parse_state = S_WRITE_PWM_PHASE;
+		} break;
+		case S_WRITE_PWM_PHASE: {
+			msg[S_WRITE_PWM_PHASE] = data_byte;
+			config_parse_state = S_WRITE_PWM_DITHERING;
+		} break;
+		case S_WRITE_PWM_DITHERING: {
+			msg[S_WRITE_PWM_DITHERING] = data_byte;
+			config_parse_state = S_WRITE_INPUT_MODE;
+		} break;
+		case S_WRITE_INPUT_MODE: {
+			msg[S_WRITE_INPUT_MODE] = data_byte;
+			config_parse_state = S_WRITE_INPUT_TIMEOUT;
+		} break;
+		case S_WRITE_INPUT_TIMEOUT: {
+			msg[S_WRITE_INPUT_TIMEOUT] = data_byte;
+			config_parse_state = S_WRITE_MIN_WIDTH_HIGH;
+		} break;
+		case S_WRITE_MIN_WIDTH_HIGH: {
+			msg[S_WRITE_MIN_WIDTH_HIGH] = data_byte;
+			config_parse_state = S_WRITE_MIN_WIDTH_LOW;
+		} break;
+		case S_WRITE_MIN_WIDTH_LOW: {
+			msg[S_WRITE_MIN_WIDTH_LOW] = data_byte;
+			config_parse_state = S_WRITE_MAX_WIDTH_HIGH;
+		} break;
+		case S_WRITE_MAX_WIDTH_HIGH: {
+			msg[S_WRITE_MAX_WIDTH_HIGH] = data_byte;
+			config_parse_state = S_WRITE_MAX_WIDTH_LOW;
+		} break;
+		case S_WRITE_MAX_WIDTH_LOW: {
+			msg[S_WRITE_MAX_WIDTH_LOW] = data_byte;
+			config_parse_state = S_WRITE_MIN_PERIOD;
+		} break;
+		case S_WRITE_MIN_PERIOD: {
+			msg[S_WRITE_MIN_PERIOD] = data_byte;
+			config_parse_state = S_WRITE_MAX_PERIOD;
+		} break;
+		case S_WRITE_MAX_PERIOD: {
+			msg[S_WRITE_MAX_PERIOD] = data_byte;
+			config_parse_state = S_WRITE_FILTER_KERNEL_CH1;
+		} break;
+		case S_WRITE_FILTER_KERNEL_CH1: {
+			msg[S_WRITE_FILTER_KERNEL_CH1] = data_byte;
+			config_parse_state = S_WRITE_FILTER_PARAM_CH1;
+		} break;
+		case S_WRITE_FILTER_PARAM_CH1: {
+			msg[S_WRITE_FILTER_PARAM_CH1] = data_byte;
+			config_parse_state = S_WRITE_FILTER_KERNEL_CH2;
+		} break;
+		case S_WRITE_FILTER_KERNEL_CH2: {
+			msg[S_WRITE_FILTER_KERNEL_CH2] = data_byte;
+			config_parse_state = S_WRITE_FILTER_PARAM_CH2;
+		} break;
+		case S_WRITE_FILTER_PARAM_CH2: {
+			msg[S_WRITE_FILTER_PARAM_CH2] = data_byte;
+			config_parse_state = S_WRITE_AUX_CHANNEL;
+		} break;
+		case S_WRITE_AUX_CHANNEL: {
+			msg[S_WRITE_AUX_CHANNEL] = data_byte;
+			config_parse_state = S_REQUEST_KIND;
+			config_write(config_done_ptr);
+		} break;
 		default: {
 			config_parse_state = S_REQUEST_KIND;
 		} break;
 	}
+}
+
+/**
+ * @brief applies a completely received write request to the configuration and stores it in the eeprom
+ */
+static void config_write(bool *config_done_ptr) {
+	uint16_t const reversal_dead_time_us = ((uint16_t)(msg[S_WRITE_DEAD_TIME_HIGH])<<8) + msg[S_WRITE_DEAD_TIME_LOW];
+	uint16_t const pulse_min_width_us = ((uint16_t)(msg[S_WRITE_MIN_WIDTH_HIGH])<<8) + msg[S_WRITE_MIN_WIDTH_LOW];
+	uint16_t const pulse_max_width_us = ((uint16_t)(msg[S_WRITE_MAX_WIDTH_HIGH])<<8) + msg[S_WRITE_MAX_WIDTH_LOW];
+	// pwm frequency, phase and dithering, aux output, drive modes, dead time, input mode, timeout, pulse validation and filters, reject the whole request if the motor control or the input can not run it.
+	// the pwm mode has to leave the share of the cpu the decoder of the input mode holds the pwm interrupt back, everything is applied once all checks passed
+	if(!filter_kernel_valid((E_FILTER_KERNEL)(msg[S_WRITE_FILTER_KERNEL_CH1]), msg[S_WRITE_FILTER_PARAM_CH1]) || !filter_kernel_valid((E_FILTER_KERNEL)(msg[S_WRITE_FILTER_KERNEL_CH2]), msg[S_WRITE_FILTER_PARAM_CH2]) || msg[S_WRITE_INPUT_MODE] > INPUT_AUTO || msg[S_WRITE_INPUT_TIMEOUT] < INPUT_MIN_TIMEOUT_MS || !pulse_validation_valid(pulse_min_width_us, pulse_max_width_us, msg[S_WRITE_MIN_PERIOD], msg[S_WRITE_MAX_PERIOD]) || msg[S_WRITE_DRIVE_MODE_LEFT] > DRIVE_BRAKE || msg[S_WRITE_DRIVE_MODE_RIGHT] > DRIVE_BRAKE || reversal_dead_time_us > MAX_REVERSAL_DEAD_TIME_US || msg[S_WRITE_AUX_CHANNEL] > INPUT_MAX_CHANNELS || !pwm_mode_valid((E_PWM_FREQUENCY)(msg[S_WRITE_PWM_FREQ]), (E_PWM_PHASE)(msg[S_WRITE_PWM_PHASE]), msg[S_WRITE_PWM_DITHERING] != 0, msg[S_WRITE_AUX_CHANNEL] != 0, input_blocking_load((E_INPUT_MODE)(msg[S_WRITE_INPUT_MODE])))) {
+		uint8_t msg_reply = MSG_NOK;
+		virtual_serial_send_data(&msg_reply, 1);
+		return;
+	}
+	configuration.pwm_frequency = (E_PWM_FREQUENCY)(msg[S_WRITE_PWM_FREQ]);
+	configuration.pwm_phase = (E_PWM_PHASE)(msg[S_WRITE_PWM_PHASE]);
+	configuration.pwm_dithering = (msg[S_WRITE_PWM_DITHERING] != 0);
+	configuration.aux_channel = msg[S_WRITE_AUX_CHANNEL];
+	set_pwm_mode(configuration.pwm_frequency, configuration.pwm_phase, configuration.pwm_dithering, configuration.aux_channel != 0);
+	configuration.drive_mode_motor_left = (E_MOTOR_DRIVE_MODE)(msg[S_WRITE_DRIVE_MODE_LEFT]);
+	configuration.drive_mode_motor_right = (E_MOTOR_DRIVE_MODE)(msg[S_WRITE_DRIVE_MODE_RIGHT]);
+	set_drive_mode(OUTPUT_LEFT, configuration.drive_mode_motor_left);
+	set_drive_mode(OUTPUT_RIGHT, configuration.drive_mode_motor_right);
+	configuration.reversal_dead_time_us = reversal_dead_time_us;
+	set_reversal_dead_time(configuration.reversal_dead_time_us);
+	configuration.input_mode = (E_INPUT_MODE)(msg[S_WRITE_INPUT_MODE]);
+	set_input_mode(configuration.input_mode); // INPUT_AUTO is detected in INIT
+	configuration.input_timeout_ms = msg[S_WRITE_INPUT_TIMEOUT];
+	set_input_timeout(configuration.input_timeout_ms);
+	configuration.pulse_min_width_us = pulse_min_width_us;
+	configuration.pulse_max_width_us = pulse_max_width_us;
+	configuration.frame_period_min_ms = msg[S_WRITE_MIN_PERIOD];
+	configuration.frame_period_max_ms = msg[S_WRITE_MAX_PERIOD];
+	set_pulse_validation(configuration.pulse_min_width_us, configuration.pulse_max_width_us, configuration.frame_period_min_ms, configuration.frame_period_max_ms);
+	// configuration byte
+	if(msg[S_WRITE_CONFIG] & S_CONFIG_CONTROL_MASK) configuration.control = TANK;
+	else configuration.control = DELTA;
+	// deadzone byte
+	configuration.deadzone = msg[S_WRITE_DEADZONE];
+	// channel 1 min and maximum values
+	configuration.remote_control_min_value_ch_1 = msg[S_WRITE_CH1_MIN];
+	configuration.remote_control_max_value_ch_1 = msg[S_WRITE_CH1_MAX];
+	// channel 2 min and maximum values
+	configuration.remote_control_min_value_ch_2 = msg[S_WRITE_CH2_MIN];
+	configuration.remote_control_max_value_ch_2 = msg[S_WRITE_CH2_MAX];
+	// r - s - t values
+	// channel 1
+	configuration.r1 = (int32_t)(((uint32_t)(r1[0])<<24) + ((uint32_t)(r1[1])<<16) + ((uint32_t)(r1[2])<<8) + ((uint32_t)(r1[3])));
+	configuration.s1 = (int32_t)(((uint32_t)(s1[0])<<24) + ((uint32_t)(s1[1])<<16) + ((uint32_t)(s1[2])<<8) + ((uint32_t)(s1[3])));
+	configuration.t1 = configuration.s1;
+	// channel 2
+	configuration.r2 = (int32_t)(((uint32_t)(r2[0])<<24) + ((uint32_t)(r2[1])<<16) + ((uint32_t)(r2[2])<<8) + ((uint32_t)(r2[3])));
+	configuration.s2 = configuration.s1;
+	configuration.t2 = 0 - configuration.s1; // *(-1)
+	// update the linear mapper 2d
+	update_linear_mapper_2d();
+	// slew rates
+	configuration.accel_rate = msg[S_WRITE_ACCEL_RATE];
+	configuration.decel_rate = msg[S_WRITE_DECEL_RATE];
+	configuration.reversal_rate = msg[S_WRITE_REVERSAL_RATE];
+	update_slew_limiter();
+	// filters
+	configuration.filter_kernel_ch_1 = (E_FILTER_KERNEL)(msg[S_WRITE_FILTER_KERNEL_CH1]);
+	configuration.filter_param_ch_1 = msg[S_WRITE_FILTER_PARAM_CH1];
+	configuration.filter_kernel_ch_2 = (E_FILTER_KERNEL)(msg[S_WRITE_FILTER_KERNEL_CH2]);
+	configuration.filter_param_ch_2 = msg[S_WRITE_FILTER_PARAM_CH2];
+	update_filter();
+	// write data to eeprom
+	eeprom_write_block((void*)(&configuration), CONFIG_EEPROM_ADDRESS, sizeof(configuration));
+	// configuration is now done here
+	*config_done_ptr = true;
+	// send answer
+	uint8_t msg_reply = MSG_OK;
+	virtual_serial_send_data(&msg_reply, 1);
+}
+
+/**
+ * @brief stores the detected input mode in the eeprom, if it differs from the one of the last detection
+ */
+void config_store_detected_input_mode(E_INPUT_MODE const mode) {
+	if(configuration.input_mode_detected == mode) return;
+	configuration.input_mode_detected = mode;
+	eeprom_write_block((void*)(&configuration), CONFIG_EEPROM_ADDRESS, sizeof(configuration));
 }
\ No newline at end of file
@@ -29,6 +29,9 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "control.h"
+#include "motor_control.h"
+#include "input.h"
+#include "filter.h"
 
 typedef struct {
 	uint8_t eeprom_written; // status flag, for intial writing of the eeprom
@@ -40,6 +43,27 @@ typedef struct {
 	uint8_t remote_control_max_value_ch_2; // maximum pulse width of the remote control ch 2
 	int32_t r1, s1, t1; // channel 1
 	int32_t r2, s2, t2; // channel 2
+	E_PWM_FREQUENCY pwm_frequency; // carrier frequency of the motor pwm
+	E_PWM_PHASE pwm_phase; // phase relation of the pwm of both motors
+	bool pwm_dithering; // spread the fractional part of the duty cycle over successive pwm periods
+	E_MOTOR_DRIVE_MODE drive_mode_motor_left; // state of the left h-bridge during the pwm off time and at zero speed
+	E_MOTOR_DRIVE_MODE drive_mode_motor_right; // state of the right h-bridge during the pwm off time and at zero speed
+	uint16_t reversal_dead_time_us; // time in us a motor is not driven before it is driven in the opposite direction
+	uint8_t accel_rate; // maximum increase of the motor speed (0 - 255) per ms, 0 = unlimited
+	uint8_t decel_rate; // maximum decrease of the motor speed (0 - 255) per ms, 0 = unlimited
+	uint8_t reversal_rate; // maximum change of the motor speed (0 - 255) per ms while reversing, 0 = unlimited
+	E_INPUT_MODE input_mode; // signal type of the receiver, INPUT_AUTO = detected at boot
+	E_INPUT_MODE input_mode_detected; // signal type found by the last detection, tried first at the next boot (INPUT_AUTO = none)
+	uint8_t input_timeout_ms; // a channel without a pulse for that time is lost and the motors are switched off
+	uint16_t pulse_min_width_us; // shorter pwm pulses and ppm channels are rejected
+	uint16_t pulse_max_width_us; // longer pwm pulses and ppm channels are rejected
+	uint8_t frame_period_min_ms; // a pwm pulse closer to the previous one is rejected
+	uint8_t frame_period_max_ms; // a pwm pulse after a longer pause only starts the period measurement again
+	E_FILTER_KERNEL filter_kernel_ch_1; // filter of the input values of ch 1
+	uint8_t filter_param_ch_1; // number of values (average, median) or weight of a new value in 1 / 256 (iir) of ch 1
+	E_FILTER_KERNEL filter_kernel_ch_2; // filter of the input values of ch 2
+	uint8_t filter_param_ch_2; // number of values (average, median) or weight of a new value in 1 / 256 (iir) of ch 2
+	uint8_t aux_channel; // receiver channel (1 - INPUT_MAX_CHANNELS) driving the aux output, 0 = aux output off
 } s_config_data;
 
 extern volatile s_config_data configuration;
@@ -56,4 +80,9 @@ void init_config();
  */
 void config_parse_data(uint8_t const data_byte, bool *config_done_ptr);
 
+/**
+ * @brief stores the detected input mode in the eeprom, if it differs from the one of the last detection
+ */
+void config_store_detected_input_mode(E_INPUT_MODE const mode);
+
 #endif
@@ -29,11 +29,17 @@ along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
 #include "linear_mapper.h"
 #include "linear_mapper_2d.h"
 #include "filter.h"
+#include "slew_limiter.h"
+#include "input.h"
+
+#include <util/atomic.h>
 
 // calibration flag for defining when calibration of neutral position is done
 extern bool do_calibration_of_neutral_position;
 // channel selection
 typedef enum {CH1 = 0, CH2 = 1} E_CHANNEL_SELECT;
+// motor selection
+typedef enum {LEFT = 0, RIGHT = 1} E_MOTOR_SELECT;
 // maximum channel value
 static uint16_t const MAX_CHANNEL_VALUE = 500; // max 2 ms pulsewidth
 // adt data for the linear mapper
@@ -42,25 +48,127 @@ static linear_mapper map_ch1_fwd, map_ch1_bwd, map_ch2_fwd, map_ch2_bwd;
 static linear_mapper_2d map_motor_left_2d, map_motor_right_2d;
 // adt data for the filter
 static filter filt[2];
+// adt data for the slew limiter
+static slew_limiter slew[2];
+// speed of the motors requested by the input signals, the sign is the direction, the magnitude the speed
+static volatile int16_t m_target[2] = {0, 0};
+// new input values were filtered since the last control tick
+static bool m_input_pending = false;
 	
 /**
- * @brief this class is called when new data has arrived - its job is to calculate new data and transmit it to the motor drivers
+ * @brief this class is called by control_tick when new data has arrived - its job is to calculate the requested motor speeds, control_tick transmits them to the motor drivers
  */
 void control_update();
 /** 
  * @brief provides a conditioning of the signal from the linear mapper to the motor control
  */
-uint8_t speed_conditioning(int16_t const s);
+uint16_t speed_conditioning(int16_t const s);
+/**
+ * @brief returns true if speed is outside the deadzone, the deadzone is configured in units of MAX_MOTOR_VALUE >> 5
+ */
+static bool outside_deadzone(uint16_t const speed);
+/**
+ * @brief stores the speed requested for a motor, it is passed on to the motor control by control_tick
+ */
+static void set_target(E_MOTOR_SELECT const motor, E_MOTOR_DIRECTION const dir, uint16_t const speed);
+/**
+ * @brief passes the configured receiver channel on to the aux output, 1 - 2 ms are 0 - 100 %
+ */
+static void update_aux_output();
 
 /** 
  * @brief initializes the control module
  */
 void init_control() {
-	init_filter(&filt[CH1], 4, 125);
-	init_filter(&filt[CH2], 4, 125);
+	update_filter();
 	
 	init_linear_mapper_2d(&map_motor_left_2d, -16320, -65, -65);
 	init_linear_mapper_2d(&map_motor_right_2d, 0, -65, 65);
+	
+	update_slew_limiter();
+}
+
+/**
+ * @brief sets the filter kernels of the input channels after a configuration via the pc, the filters start from the
+ * neutral position
+ */
+void update_filter() {
+	init_filter(&filt[CH1], configuration.filter_kernel_ch_1, configuration.filter_param_ch_1, 125);
+	init_filter(&filt[CH2], configuration.filter_kernel_ch_2, configuration.filter_param_ch_2, 125);
+}
+
+/**
+ * @brief updates the rates of the slew limiters after a configuration via the pc
+ */
+void update_slew_limiter() {
+	for(uint8_t m = LEFT; m <= RIGHT; m++) {
+		// the rates are configured in units of MAX_MOTOR_VALUE >> 5 per ms
+		init_slew_limiter(&slew[m], (uint16_t)(configuration.accel_rate) << 5, (uint16_t)(configuration.decel_rate) << 5, (uint16_t)(configuration.reversal_rate) << 5);
+	}
+}
+
+/**
+ * @brief stops both motors and the aux output immediately, the slew limiters start again from zero speed
+ */
+void control_reset() {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		m_target[LEFT] = 0;
+		m_target[RIGHT] = 0;
+	}
+	slew_limiter_reset(&slew[LEFT], 0);
+	slew_limiter_reset(&slew[RIGHT], 0);
+	set_pwm_output(OUTPUT_LEFT, FWD, 0);
+	set_pwm_output(OUTPUT_RIGHT, FWD, 0);
+	set_pwm_output(OUTPUT_AUX, FWD, 0);
+}
+
+/**
+ * @brief called every 1 ms from the main loop, calculates the requested speeds from the latest filtered input values if
+ * new values arrived since the last tick and moves the motor speeds towards them with the configured rates. So the
+ * requested speeds are calculated once per tick at most, however many channels or frames arrived, and the motors are
+ * updated at a fixed rate independent of the arrival of the input values.
+ */
+void control_tick() {
+	if(m_input_pending) {
+		m_input_pending = false;
+		control_update();
+	}
+	
+	int16_t target[2] = {0, 0};
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		target[LEFT] = m_target[LEFT];
+		target[RIGHT] = m_target[RIGHT];
+	}
+	
+	int16_t const left = slew_limiter_update(&slew[LEFT], target[LEFT]);
+	if(left >= 0) set_pwm_output(OUTPUT_LEFT, FWD, (uint16_t)(left));
+	else set_pwm_output(OUTPUT_LEFT, BWD, (uint16_t)(-left));
+	
+	int16_t const right = slew_limiter_update(&slew[RIGHT], target[RIGHT]);
+	if(right >= 0) set_pwm_output(OUTPUT_RIGHT, FWD, (uint16_t)(right));
+	else set_pwm_output(OUTPUT_RIGHT, BWD, (uint16_t)(-right));
+	
+	update_aux_output();
+}
+
+/**
+ * @brief passes the configured receiver channel on to the aux output, 1 - 2 ms are 0 - 100 %. The channel is neither
+ * filtered nor slew limited and only available with ppm and the serial protocols, the output stays off otherwise
+ */
+static void update_aux_output() {
+	if(configuration.aux_channel == 0) return;
+	uint16_t value = input_channel(configuration.aux_channel - 1);
+	if(value < (MAX_CHANNEL_VALUE >> 1)) value = MAX_CHANNEL_VALUE >> 1;
+	else if(value > MAX_CHANNEL_VALUE) value = MAX_CHANNEL_VALUE;
+	set_pwm_output(OUTPUT_AUX, FWD, (uint16_t)((uint32_t)(value - (MAX_CHANNEL_VALUE >> 1)) * MAX_MOTOR_VALUE / (MAX_CHANNEL_VALUE >> 1)));
+}
+
+/**
+ * @brief stores the speed requested for a motor, it is passed on to the motor control by control_tick
+ */
+static void set_target(E_MOTOR_SELECT const motor, E_MOTOR_DIRECTION const dir, uint16_t const speed) {
+	if(dir == FWD) m_target[motor] = speed;
+	else m_target[motor] = -(int16_t)(speed);
 }
 
 /**
@@ -71,43 +179,64 @@ void update_linear_mapper_2d() {
 	init_linear_mapper_2d(&map_motor_right_2d, configuration.r2, configuration.s2, configuration.t2);
 }
 
+/**
+ * @brief adds a value of channel c in units of 4 us to its filter. The pulses and frames were checked by the input module,
+ * values slightly outside of 1 - 2 ms are limited to it, so the 1 ms minimum pulsewidth can be subtracted without an underflow
+ */
+static void add_channel_value(E_CHANNEL_SELECT const c, uint16_t value) {
+	if(value < (MAX_CHANNEL_VALUE >> 1)) value = MAX_CHANNEL_VALUE >> 1;
+	else if(value > MAX_CHANNEL_VALUE) value = MAX_CHANNEL_VALUE;
+	// subtract the 1 ms minimum pulsewidth which we always have, equals value - 250, the max value is thereby 250
+	filter_add_value(&filt[c], value - (MAX_CHANNEL_VALUE >> 1));
+}
+
 /**
  * @brief callback function called when new data on channel 1 arrived
  */
 void control_ch1_data_callback(uint16_t const pulse_duration) {
-	if(pulse_duration <= MAX_CHANNEL_VALUE) {
-		// subtract the 1 ms minimum pulsewidth which we always have, equals pulse_duration - 250, the max value of pulse_duration is thereby 250
-		filter_add_value(&filt[CH1], pulse_duration - (MAX_CHANNEL_VALUE >> 1));
-		// call the update function
-		control_update();
-	}		
+	add_channel_value(CH1, pulse_duration);
+	// the update function is called by the next control tick
+	m_input_pending = true;
 }	
 	
 /**
  * @brief callback function called when new data on channel 2 arrived
  */
 void control_ch2_data_callback(uint16_t const pulse_duration) {
-	if(pulse_duration <= MAX_CHANNEL_VALUE) {
-		// subtract the 1 ms minimum pulsewidth which we always have, equals pulse_duration - 250, the max value of pulse_duration is thereby 250
-		filter_add_value(&filt[CH2], pulse_duration - (MAX_CHANNEL_VALUE >> 1));
-		// call the update function
-		control_update();
-	}
+	add_channel_value(CH2, pulse_duration);
+	// the update function is called by the next control tick
+	m_input_pending = true;
+}
+
+/**
+ * @brief callback function called when a frame with new data on both channels arrived (ppm, serial protocols), the values are in units of 4 us
+ */
+void control_frame_data_callback(uint16_t const ch1, uint16_t const ch2) {
+	add_channel_value(CH1, ch1);
+	add_channel_value(CH2, ch2);
+	// the requested speeds are calculated by the next control tick
+	m_input_pending = true;
 }
 
 /** 
  * @brief provides a conditioning of the signal from the linear mapper to the motor control
  */
-uint8_t speed_conditioning(int16_t const s) {
+uint16_t speed_conditioning(int16_t const s) {
 	int16_t speed = s;
-	speed >>= 5;
 	if(speed < 0) speed = 0;
-	else if(speed > 255) speed = 255;
-	return (uint8_t)(speed);
+	else if(speed > (int16_t)(MAX_MOTOR_VALUE)) speed = MAX_MOTOR_VALUE;
+	return (uint16_t)(speed);
 }
 
 /**
- * @brief this class is called when new data has arrived - its job is to calculate new data and transmit it to the motor drivers
+ * @brief returns true if speed is outside the deadzone, the deadzone is configured in units of MAX_MOTOR_VALUE >> 5
+ */
+static bool outside_deadzone(uint16_t const speed) {
+	return (speed > ((uint16_t)(configuration.deadzone) << 5));
+}
+
+/**
+ * @brief this class is called when new data has arrived - its job is to calculate the requested motor speeds, control_tick transmits them to the motor drivers
  */
 void control_update() {
 	// initial middle value of the channels
@@ -117,15 +246,24 @@ void control_update() {
 	
 	// do the calibration of the neutral position
 	if(do_calibration_of_neutral_position) {
-		MIDDLE_VALUE_CH[CH1] = filter_get_value(&filt[CH1]);
-		MIDDLE_VALUE_CH[CH2] = filter_get_value(&filt[CH2]);
+		uint8_t min_value[2] = {configuration.remote_control_min_value_ch_1, configuration.remote_control_min_value_ch_2};
+		uint8_t max_value[2] = {configuration.remote_control_max_value_ch_1, configuration.remote_control_max_value_ch_2};
+		if(input_is_digital()) {
+			// digital values (dshot) have an exact neutral position and use the full range
+			MIDDLE_VALUE_CH[CH1] = MIDDLE_VALUE_CH[CH2] = MAX_CHANNEL_VALUE >> 2;
+			min_value[CH1] = min_value[CH2] = 0;
+			max_value[CH1] = max_value[CH2] = MAX_CHANNEL_VALUE >> 1;
+		} else {
+			MIDDLE_VALUE_CH[CH1] = filter_get_value(&filt[CH1]);
+			MIDDLE_VALUE_CH[CH2] = filter_get_value(&filt[CH2]);
+		}
 		// configuration done
 		do_calibration_of_neutral_position = false;	
 		// adjust the linear mapping modules
-		init_linear_mapper(&map_ch1_bwd, configuration.remote_control_min_value_ch_1, MIDDLE_VALUE_CH[CH1], MAX_MOTOR_VALUE, 0);
-		init_linear_mapper(&map_ch1_fwd, MIDDLE_VALUE_CH[CH1], configuration.remote_control_max_value_ch_1, 0, MAX_MOTOR_VALUE);
-		init_linear_mapper(&map_ch2_bwd, configuration.remote_control_min_value_ch_2, MIDDLE_VALUE_CH[CH2], MAX_MOTOR_VALUE, 0);
-		init_linear_mapper(&map_ch2_fwd, MIDDLE_VALUE_CH[CH2], configuration.remote_control_max_value_ch_2, 0, MAX_MOTOR_VALUE);
+		init_linear_mapper(&map_ch1_bwd, min_value[CH1], MIDDLE_VALUE_CH[CH1], MAX_MOTOR_VALUE, 0);
+		init_linear_mapper(&map_ch1_fwd, MIDDLE_VALUE_CH[CH1], max_value[CH1], 0, MAX_MOTOR_VALUE);
+		init_linear_mapper(&map_ch2_bwd, min_value[CH2], MIDDLE_VALUE_CH[CH2], MAX_MOTOR_VALUE, 0);
+		init_linear_mapper(&map_ch2_fwd, MIDDLE_VALUE_CH[CH2], max_value[CH2], 0, MAX_MOTOR_VALUE);
 		// calculate offset values for correcting offsets in delta mode
 		OFFSET_CH[CH1] = (int16_t)(125) - MIDDLE_VALUE_CH[CH1];
 		OFFSET_CH[CH2] = (int16_t)(125) - MIDDLE_VALUE_CH[CH2];
@@ -141,24 +279,23 @@ void control_update() {
 	if(configuration.control == TANK) {
 		// Motor Left
 		if(m_ch_value[CH1] > MIDDLE_VALUE_CH[CH1]) { // drive forward
-			uint8_t const speed = speed_conditioning(linear_map(&map_ch1_fwd, m_ch_value[CH1]));
-			if(speed > configuration.deadzone) set_pwm_motor_left(FWD, speed);
-			else set_pwm_motor_left(FWD, 0);
+			uint16_t const speed = speed_conditioning(linear_map(&map_ch1_fwd, m_ch_value[CH1]));
+			if(outside_deadzone(speed)) set_target(LEFT, FWD, speed);
+			else set_target(LEFT, FWD, 0);
 		} else {
-			uint8_t const speed = speed_conditioning(linear_map(&map_ch1_bwd, m_ch_value[CH1]));
-			if(speed > configuration.deadzone) set_pwm_motor_left(BWD, speed);
-			else set_pwm_motor_left(BWD, 0);
+			uint16_t const speed = speed_conditioning(linear_map(&map_ch1_bwd, m_ch_value[CH1]));
+			if(outside_deadzone(speed)) set_target(LEFT, BWD, speed);
+			else set_target(LEFT, BWD, 0);
 		}
 		// Motor Right
-		set_pwm_motor_right(FWD, 0);
 		if(m_ch_value[CH2] > MIDDLE_VALUE_CH[CH2]) { // drive forward
-			uint8_t const speed = speed_conditioning(linear_map(&map_ch2_fwd, m_ch_value[CH2]));
-			if(speed > configuration.deadzone) set_pwm_motor_right(FWD, speed);
-			else set_pwm_motor_right(FWD, 0);
+			uint16_t const speed = speed_conditioning(linear_map(&map_ch2_fwd, m_ch_value[CH2]));
+			if(outside_deadzone(speed)) set_target(RIGHT, FWD, speed);
+			else set_target(RIGHT, FWD, 0);
 		} else {
-			uint8_t const speed = speed_conditioning(linear_map(&map_ch2_bwd, m_ch_value[CH2]));
-			if(speed > configuration.deadzone) set_pwm_motor_right(BWD, speed);
-			else set_pwm_motor_right(BWD, 0);
+			uint16_t const speed = speed_conditioning(linear_map(&map_ch2_bwd, m_ch_value[CH2]));
+			if(outside_deadzone(speed)) set_target(RIGHT, BWD, speed);
+			else set_target(RIGHT, BWD, 0);
 		}			
 			
 	/************************************************************************/
@@ -167,30 +304,30 @@ void control_update() {
 	} else if(configuration.control == DELTA) {
 		// Motor Left
 		{
-			int32_t speed = (linear_map_2d(&map_motor_left_2d, (m_ch_value[CH1] + OFFSET_CH[CH1]), (m_ch_value[CH2] + OFFSET_CH[CH2])) >> 5);
+			int32_t speed = linear_map_2d(&map_motor_left_2d, (m_ch_value[CH1] + OFFSET_CH[CH1]), (m_ch_value[CH2] + OFFSET_CH[CH2]));
 			if(speed > 0) {
-				if(speed > 255) speed = 255;
-				if(speed > configuration.deadzone) set_pwm_motor_left(FWD, (uint8_t)(speed));
-				else set_pwm_motor_left(FWD, 0);			
+				if(speed > MAX_MOTOR_VALUE) speed = MAX_MOTOR_VALUE;
+				if(outside_deadzone(speed)) set_target(LEFT, FWD, (uint16_t)(speed));
+				else set_target(LEFT, FWD, 0);			
 			} else {
-				if(speed < -255) speed = -255;
+				if(speed < -(int32_t)(MAX_MOTOR_VALUE)) speed = -(int32_t)(MAX_MOTOR_VALUE);
 				speed = 0 - speed; // * (-1)
-				if(speed > configuration.deadzone) set_pwm_motor_left(BWD, (uint8_t)(speed));
-				else set_pwm_motor_left(BWD, 0);
+				if(outside_deadzone(speed)) set_target(LEFT, BWD, (uint16_t)(speed));
+				else set_target(LEFT, BWD, 0);
 			}
 		}		
 		// Motor Right
 		{
-			int32_t speed = (linear_map_2d(&map_motor_right_2d, (m_ch_value[CH1] + OFFSET_CH[CH1]), (m_ch_value[CH2] + OFFSET_CH[CH2])) >> 5);
+			int32_t speed = linear_map_2d(&map_motor_right_2d, (m_ch_value[CH1] + OFFSET_CH[CH1]), (m_ch_value[CH2] + OFFSET_CH[CH2]));
 			if(speed > 0) {
-				if(speed > 255) speed = 255;
-				if(speed > configuration.deadzone) set_pwm_motor_right(FWD, (uint8_t)(speed));
-				else set_pwm_motor_right(FWD, 0);
+				if(speed > MAX_MOTOR_VALUE) speed = MAX_MOTOR_VALUE;
+				if(outside_deadzone(speed)) set_target(RIGHT, FWD, (uint16_t)(speed));
+				else set_target(RIGHT, FWD, 0);
 			} else {
-				if(speed < -255) speed = -255;
+				if(speed < -(int32_t)(MAX_MOTOR_VALUE)) speed = -(int32_t)(MAX_MOTOR_VALUE);
 				speed = 0 - speed; // * (-1)
-				if(speed > configuration.deadzone) set_pwm_motor_right(BWD, (uint8_t)(speed));
-				else set_pwm_motor_right(BWD, 0);
+				if(outside_deadzone(speed)) set_target(RIGHT, BWD, (uint16_t)(speed));
+				else set_target(RIGHT, BWD, 0);
 			}
 		}		
 	}
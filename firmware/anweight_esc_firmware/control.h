@@ -41,6 +41,28 @@ void init_control();
  */ 
 void update_linear_mapper_2d();
 
+/**
+ * @brief sets the filter kernels of the input channels after a configuration via the pc
+ */
+void update_filter();
+
+/**
+ * @brief updates the rates of the slew limiters after a configuration via the pc
+ */
+void update_slew_limiter();
+
+/**
+ * @brief stops both motors and the aux output immediately, the slew limiters start again from zero speed
+ */
+void control_reset();
+
+/**
+ * @brief called every 1 ms from the main loop, calculates the requested speeds from the latest filtered input values if
+ * new values arrived since the last tick (also the calibration of the neutral position) and moves the motor speeds
+ * towards them with the configured rates, the aux output follows its receiver channel
+ */
+void control_tick();
+
 /**
  * @brief callback function called when new data on channel 1 arrived
  */
@@ -51,4 +73,9 @@ void control_ch1_data_callback(uint16_t const pulse_duration);
  */
 void control_ch2_data_callback(uint16_t const pulse_duration);
 
+/**
+ * @brief callback function called when a frame with new data on both channels arrived (ppm, serial protocols), the values are in units of 4 us
+ */
+void control_frame_data_callback(uint16_t const ch1, uint16_t const ch2);
+
 #endif /* CONTROL_H_ */
\ No newline at end of file
@@ -0,0 +1,110 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @author Alexander Entinger, BSc
+* @brief this module decodes the crsf frames of a crossfire or expresslrs receiver
+* @file crsf.c
+*/
+
+#include "crsf.h"
+
+#include <avr/io.h>
+
+/*
+ * frame (up to 64 bytes):
+ *   address | length (type + payload + crc) | type | payload | crc8 (poly 0xD5) over type and payload
+ * the channels are sent with type 0x16, 22 bytes payload = 16 channels with 11 bit, lsb first, like sbus.
+ * All other frame types (link statistics, ...) are checked but not used. A gap on the line starts a new frame, so a
+ * corrupted length byte does not make the parser look for an address byte within the payload until the next gap.
+ */
+#define CRSF_MAX_FRAME_SIZE		(SERIAL_MAX_FRAME_SIZE)
+#define CRSF_ADDRESS_FC			(0xC8) // flight controller
+#define CRSF_ADDRESS_BROADCAST	(0x00)
+#define CRSF_ADDRESS_RECEIVER	(0xEC)
+#define CRSF_MIN_LENGTH			(2) // type + crc
+#define CRSF_TYPE_RC_CHANNELS	(0x16)
+#define CRSF_RC_CHANNELS_LENGTH	(24) // type + 22 bytes + crc
+#define CRSF_CRC_POLY			(0xD5)
+
+static uint8_t m_idx = 0; // index of the next byte within the frame
+
+/**
+ * @brief crc8 dvb-s2 over len bytes of data
+ */
+static uint8_t crsf_crc8(uint8_t const *data, uint8_t const len) {
+	uint8_t crc = 0;
+	for(uint8_t i = 0; i < len; i++) {
+		crc ^= data[i];
+		for(uint8_t b = 0; b < 8; b++) {
+			if(crc & 0x80) crc = (crc << 1) ^ CRSF_CRC_POLY;
+			else crc <<= 1;
+		}
+	}
+	return crc;
+}
+
+/**
+ * @brief discards a partially received frame, the next frame starts with the next address byte
+ */
+static void crsf_reset() {
+	m_idx = 0;
+}
+
+/**
+ * @brief processes one received byte
+ */
+static E_SERIAL_FRAME crsf_parse(uint8_t const data, bool const gap) {
+	// every packet rate leaves the line idle between two frames, a gap starts a new frame. Frames following each other
+	// without a gap are synchronised to the address and the length
+	if(gap) m_idx = 0;
+	if(m_idx == 0) {
+		if(data != CRSF_ADDRESS_FC && data != CRSF_ADDRESS_BROADCAST && data != CRSF_ADDRESS_RECEIVER) return SERIAL_FRAME_INCOMPLETE;
+	} else if(m_idx == 1 && (data < CRSF_MIN_LENGTH || data > CRSF_MAX_FRAME_SIZE - 2)) {
+		m_idx = 0;
+		return SERIAL_FRAME_ERROR;
+	}
+	serial_frame_buffer[m_idx++] = data;
+	if(m_idx < 2 || m_idx < serial_frame_buffer[1] + 2) return SERIAL_FRAME_INCOMPLETE;
+	
+	uint8_t const length = serial_frame_buffer[1];
+	m_idx = 0;
+	if(crsf_crc8(&serial_frame_buffer[2], length - 1) != serial_frame_buffer[length + 1]) return SERIAL_FRAME_ERROR;
+	if(serial_frame_buffer[2] != CRSF_TYPE_RC_CHANNELS) return SERIAL_FRAME_OTHER;
+	if(length != CRSF_RC_CHANNELS_LENGTH) return SERIAL_FRAME_ERROR;
+	return SERIAL_FRAME_CHANNELS;
+}
+
+/**
+ * @brief unpacks the channels of the frame just completed in units of 4 us
+ */
+static uint8_t crsf_get_channels(uint16_t *channels) {
+	serial_unpack_11bit(&serial_frame_buffer[3], CRSF_NUM_CHANNELS, channels);
+	return 0; // crsf has no failsafe flag, the receiver stops sending the channels
+}
+
+serial_decoder const CRSF_DECODER PROGMEM = {
+	.baudrate = 400000,
+	.double_speed = true, // exact 400000 baud
+	.frame_format = (1<<UCSZ11) | (1<<UCSZ10), // 8 data bits, no parity, 1 stop bit
+	.num_channels = CRSF_NUM_CHANNELS,
+	.reset = crsf_reset,
+	.parse = crsf_parse,
+	.get_channels = crsf_get_channels
+};
@@ -0,0 +1,39 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @author Alexander Entinger, BSc
+* @brief this module decodes the crsf frames of a crossfire or expresslrs receiver
+* @file crsf.h
+*/
+
+#ifndef CRSF_H_
+#define CRSF_H_
+
+#include "serial_decoder.h"
+
+#define CRSF_NUM_CHANNELS		(16)
+
+/**
+ * @brief crsf: 400000 baud, 8N1, the receiver has to be set to 400000 baud since 420000 baud can not be generated
+ * accurately enough from 16 MHz (4.8 % error)
+ */
+extern serial_decoder const CRSF_DECODER PROGMEM;
+
+#endif /* CRSF_H_ */
@@ -0,0 +1,92 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @author Alexander Entinger, BSc
+* @brief this module reads dshot frames of a flight controller from the receiver pins
+* @file dshot.c
+*/
+
+#include "dshot.h"
+
+#include <avr/io.h>
+#include <stdbool.h>
+
+#define DSHOT_FRAME_BITS	(16)
+// cycles of one poll of the pin: in, and, breq, subi, brne
+#define DSHOT_POLL_CYCLES	(6)
+
+dshot_timing const DSHOT150_TIMING = {107, 60, (3 * 107 / 2) / DSHOT_POLL_CYCLES};
+
+/*
+ * A dshot frame consists of 11 bit throttle, 1 bit telemetry request and a 4 bit crc (xor of the nibbles), msb first.
+ * Every bit starts with a rising edge, the high time tells a 1 (75 % of the bit) from a 0 (37.5 %). ICP1 drives the
+ * left h-bridge, so the bits are timed by polling the pin with interrupts disabled, TCNT1 is read after every edge.
+ * A poll takes DSHOT_POLL_CYCLES, the error of a high time is below 6 cycles at a margin of 20 cycles.
+ * The rising edge of the first bit is only known from the second one (one bit period earlier), its falling edge is
+ * measured if the pin is still high at the start of the interrupt, otherwise the first bit is a 0 if the interrupt
+ * started within the high time threshold, which holds for dshot150 (entry of the edge interrupts ~ 2.5 us of 3.75 us).
+ * The high time of a 1 of dshot300 (2.5 us) is shorter than the entry of the edge interrupts, so it is not supported.
+ * Cycle budget: a frame blocks the interrupts for 16 bits + 1.5 bits of the gap check ~ 117 us, input.c reads one frame
+ * per ms (11.7 %). Pwm edges due within the frame are applied late by the catching up pwm interrupt, so the stall counts
+ * into the cpu budget of the pwm (input_blocking_load), pwm modes without room for it are rejected with dshot. The usb
+ * interrupts are only active while configuring.
+ */
+
+/**
+ * @brief reads the rest of the dshot frame whose first rising edge triggered an edge interrupt, called with interrupts
+ * disabled from the edge interrupt, now is the timer value read at the start of the interrupt
+ */
+E_DSHOT_FRAME dshot_read_frame(uint8_t const pin_mask, uint16_t const now, dshot_timing const *timing, uint16_t *throttle) {
+	uint8_t const limit = timing->poll_limit;
+	uint8_t n = 0;
+	uint16_t bits = 0;
+	bool first_bit_known = true;
+	
+	// first bit, its rising edge triggered the interrupt
+	bool const first_high = (PIND & pin_mask) != 0;
+	for(n = limit; (PIND & pin_mask) && --n; ) { }
+	if(n == 0) return DSHOT_FRAME_INCOMPLETE;
+	uint16_t const first_fall = TCNT1;
+	
+	for(uint8_t b = 1; b < DSHOT_FRAME_BITS; b++) {
+		for(n = limit; !(PIND & pin_mask) && --n; ) { }
+		if(n == 0) return DSHOT_FRAME_INCOMPLETE; // the interrupt occurred in the middle of a frame
+		uint16_t const rise = TCNT1;
+		for(n = limit; (PIND & pin_mask) && --n; ) { }
+		if(n == 0) return DSHOT_FRAME_INCOMPLETE;
+		uint16_t const fall = TCNT1;
+		if(b == 1) {
+			uint16_t const first_rise = rise - timing->bit_ticks;
+			if(first_high) bits = ((uint16_t)(first_fall - first_rise) > timing->high_threshold_ticks) ? 1 : 0;
+			else first_bit_known = ((uint16_t)(now - first_rise) <= timing->high_threshold_ticks); // fell before, a 0
+		}
+		bits <<= 1;
+		if((uint16_t)(fall - rise) > timing->high_threshold_ticks) bits |= 1;
+	}
+	
+	// the frame has to be followed by a gap, otherwise the interrupt occurred in the middle of a frame
+	for(n = limit; !(PIND & pin_mask) && --n; ) { }
+	if(n != 0 || !first_bit_known) return DSHOT_FRAME_INCOMPLETE;
+	
+	uint16_t const value = bits >> 4;
+	if(((value ^ (value >> 4) ^ (value >> 8)) & 0x0F) != (bits & 0x0F)) return DSHOT_FRAME_CRC_ERROR;
+	*throttle = value >> 1;
+	return DSHOT_FRAME_OK;
+}
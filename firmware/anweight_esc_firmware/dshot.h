@@ -0,0 +1,60 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @author Alexander Entinger, BSc
+* @brief this module reads dshot frames of a flight controller from the receiver pins
+* @file dshot.h
+*/
+
+#ifndef DSHOT_H_
+#define DSHOT_H_
+
+#include <stdint.h>
+
+typedef enum {DSHOT_FRAME_OK = 0, DSHOT_FRAME_INCOMPLETE = 1, DSHOT_FRAME_CRC_ERROR = 2} E_DSHOT_FRAME;
+
+/**
+ * timing of a dshot bit rate in timer ticks of 62.5 ns, which are cpu cycles at 16 MHz
+ */
+typedef struct dshot_timing {
+	uint8_t bit_ticks; // period of one bit
+	uint8_t high_threshold_ticks; // a bit with a longer high time is a 1
+	uint8_t poll_limit; // polls of the pin for an edge before the frame is over, 1.5 bit periods
+} dshot_timing;
+
+// throttle values: 0 = disarmed, 1 - 47 = commands, 48 - 1047 = reverse, 1048 - 2047 = forward (3d mode)
+#define DSHOT_MIN_THROTTLE		(48)
+#define DSHOT_3D_FWD_THROTTLE	(1048)
+
+/**
+ * @brief dshot150: 150 kbit/s, 1 = 5 us high, 0 = 2.5 us high of 6.67 us
+ */
+extern dshot_timing const DSHOT150_TIMING;
+
+/**
+ * @brief reads the rest of the dshot frame whose first rising edge triggered an edge interrupt, called with interrupts
+ * disabled from the edge interrupt, now is the timer value read at the start of the interrupt
+ * @param pin_mask bit of the receiver pin in PIND
+ * @param throttle the 11 bit throttle value of a valid frame
+ * @return DSHOT_FRAME_INCOMPLETE if the interrupt occurred in the middle of a frame or too late for the first bit
+ */
+E_DSHOT_FRAME dshot_read_frame(uint8_t const pin_mask, uint16_t const now, dshot_timing const *timing, uint16_t *throttle);
+
+#endif /* DSHOT_H_ */
@@ -24,39 +24,121 @@
  */
 
 #include "filter.h"
-#include <stdlib.h>
+
+#define FILTER_MEDIAN_MAX_SIZE	(5)
+#define FILTER_IIR_SHIFT		(8)
+
+/**
+ * @brief returns true if param is valid for the kernel
+ */
+bool filter_kernel_valid(E_FILTER_KERNEL const kernel, uint8_t const param) {
+	switch(kernel) {
+	case FILTER_AVERAGE: return (param >= 1 && param <= FILTER_MAX_SIZE);
+	case FILTER_MEDIAN: return (param == 3 || param == 5);
+	case FILTER_IIR: return (param >= 1);
+	case FILTER_ADAPTIVE: return (param >= 1);
+	case FILTER_BYPASS: return true;
+	default: return false;
+	}
+}
 
 /** 
- * @brief create a filter with the the size 'size' and initializes the values with the value 'init_value'
+ * @brief create a filter with the kernel and its parameter and initializes the values with the value 'init_value'
  */
-void init_filter(filter *f, uint8_t const size, uint16_t const init_value) {
-	f->p_data = (uint16_t*)malloc(size * sizeof(uint16_t));
-	if(f->p_data != 0) f->size = size;
-	else f->size = 0;
+void init_filter(filter *f, E_FILTER_KERNEL const kernel, uint8_t const param, uint16_t const init_value) {
+	f->kernel = kernel;
+	f->size = 1;
+	f->alpha = 1;
+	if(kernel == FILTER_AVERAGE) {
+		if(param > FILTER_MAX_SIZE) f->size = FILTER_MAX_SIZE;
+		else if(param > 1) f->size = param;
+	} else if(kernel == FILTER_MEDIAN) {
+		f->size = (param > 3) ? FILTER_MEDIAN_MAX_SIZE : 3;
+	} else if(kernel == FILTER_IIR) {
+		if(param > 1) f->alpha = param;
+	} else if(kernel == FILTER_ADAPTIVE) {
+		f->threshold = (param > 1) ? param : 1;
+		f->threshold_recip = (uint16_t)(65536UL / f->threshold); // 0 for a threshold of 1, every change passes then
+	} else {
+		f->kernel = FILTER_BYPASS;
+	}
 	f->pos = 0;
+	f->sum = 0;
+	f->state = (uint32_t)(init_value) << FILTER_IIR_SHIFT;
+	f->value = init_value;
 	
 	for(uint8_t i=0; i<f->size; i++) {
-		f->p_data[i] = init_value;
+		f->data[i] = init_value;
+		f->sum += init_value;
 	}
 }
 
 /**
- * @brief adds the value val to the filter
+ * @brief returns the median of the size (up to FILTER_MEDIAN_MAX_SIZE) values, sorts a copy by insertion
+ */
+static uint16_t median(uint16_t const *data, uint8_t const size) {
+	uint16_t sorted[FILTER_MEDIAN_MAX_SIZE];
+	for(uint8_t i=0; i<size; i++) {
+		uint8_t j = i;
+		for(; j>0 && sorted[j - 1] > data[i]; j--) sorted[j] = sorted[j - 1];
+		sorted[j] = data[i];
+	}
+	return sorted[size >> 1];
+}
+
+/**
+ * @brief moves the state of the iir by alpha / 256 of the difference diff to the new value and calculates the filtered
+ * value, the step is rounded symmetrically, so the state settles less than half a unit from the value for every alpha
+ */
+static void iir_step(filter *f, int32_t const diff, uint16_t const alpha) {
+	if(diff >= 0) f->state += (uint32_t)((diff * alpha + (1 << (FILTER_IIR_SHIFT - 1))) >> FILTER_IIR_SHIFT);
+	else f->state -= (uint32_t)((-diff * alpha + (1 << (FILTER_IIR_SHIFT - 1))) >> FILTER_IIR_SHIFT);
+	f->value = (uint16_t)((f->state + (1 << (FILTER_IIR_SHIFT - 1))) >> FILTER_IIR_SHIFT);
+}
+
+/**
+ * @brief adds the value val to the filter and calculates the filtered value, constant time: the average replaces the
+ * oldest value in the running sum, the median sorts at most 5 values, the iir moves its state by alpha / 256 of the
+ * difference to val, the adaptive filter with a weight of FILTER_ADAPTIVE_MIN_ALPHA / 256 up to 1 proportional to the
+ * difference, with the reciprocal of the threshold instead of a division
  */
 void filter_add_value(filter *f, uint16_t const val) {
-	if(f->p_data != 0) {
-		f->p_data[f->pos] = val;
-		f->pos = (f->pos + 1) % f->size;
-	}		
+	switch(f->kernel) {
+	case FILTER_AVERAGE: {
+		f->sum = f->sum - f->data[f->pos] + val;
+		f->data[f->pos] = val;
+		f->value = f->sum / f->size;
+	} break;
+	case FILTER_MEDIAN: {
+		f->data[f->pos] = val;
+		f->value = median(f->data, f->size);
+	} break;
+	case FILTER_IIR: {
+		iir_step(f, ((int32_t)(val) << FILTER_IIR_SHIFT) - (int32_t)(f->state), f->alpha);
+	} break;
+	case FILTER_ADAPTIVE: {
+		int32_t const diff = ((int32_t)(val) << FILTER_IIR_SHIFT) - (int32_t)(f->state);
+		uint16_t const change = (uint16_t)(((diff >= 0) ? diff : -diff) >> FILTER_IIR_SHIFT);
+		if(change >= f->threshold) {
+			f->state = (uint32_t)(val) << FILTER_IIR_SHIFT;
+			f->value = val;
+		} else {
+			uint16_t alpha = (uint16_t)(((uint32_t)(change) * f->threshold_recip) >> FILTER_IIR_SHIFT);
+			if(alpha < FILTER_ADAPTIVE_MIN_ALPHA) alpha = FILTER_ADAPTIVE_MIN_ALPHA;
+			iir_step(f, diff, alpha);
+		}
+	} break;
+	default: {
+		f->value = val;
+	} break;
+	}
+	f->pos++;
+	if(f->pos == f->size) f->pos = 0;
 }
 
 /**
  * @brief returns the filtered value
  */
 uint16_t filter_get_value(filter *f) {
-	uint16_t sum = 0;
-	for(uint8_t i=0; i<f->size; i++) {
-		sum += f->p_data[i];	
-	}
-	return (sum / f->size);
+	return f->value;
 }
\ No newline at end of file
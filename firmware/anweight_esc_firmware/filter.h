@@ -27,21 +27,54 @@
 #define FILTER_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
-// definition of adt filter
+// maximum number of values of a filter, the storage is part of the adt so no heap is needed
+#define FILTER_MAX_SIZE	(16)
+
+/**
+ * FILTER_AVERAGE: moving average over the last param values (1 - FILTER_MAX_SIZE), smooths noise but delays steps by
+ * half the window
+ * FILTER_MEDIAN: median of the last param values (3 or 5), removes single (median of 5: two) spikes, passes steps on
+ * after 2 (3) values
+ * FILTER_IIR: first order low pass, a new value is weighted with param / 256 (1 - 255)
+ * FILTER_BYPASS: passes the values on unfiltered, param is not used
+ * FILTER_ADAPTIVE: first order low pass whose weight of a new value grows with the change, a change of at least param
+ * (1 - 255, in units of the values) passes at once, small changes (jitter) are weighted down to
+ * FILTER_ADAPTIVE_MIN_ALPHA / 256
+ */
+typedef enum {FILTER_AVERAGE = 0, FILTER_MEDIAN = 1, FILTER_IIR = 2, FILTER_BYPASS = 3, FILTER_ADAPTIVE = 4} E_FILTER_KERNEL;
+
+// weight of a new value in units of 1 / 256 for the smallest changes of FILTER_ADAPTIVE
+#define FILTER_ADAPTIVE_MIN_ALPHA	(16)
+
+// definition of adt filter, the filtered value is calculated when a value is added
 typedef struct filter {
-	uint16_t *p_data;
-	uint8_t size;
+	E_FILTER_KERNEL kernel;
+	uint16_t data[FILTER_MAX_SIZE]; // last values (average, median)
+	uint16_t sum; // running sum of data[0] - data[size - 1] (average), FILTER_MAX_SIZE values up to 4095 fit
+	uint32_t state; // filtered value with 8 fractional bits (iir, adaptive)
+	uint16_t value; // filtered value
+	uint8_t size; // number of values (average, median)
+	uint8_t alpha; // weight of a new value in units of 1 / 256 (iir)
+	uint8_t threshold; // change which passes at once (adaptive)
+	uint16_t threshold_recip; // 65536 / threshold (adaptive)
 	uint8_t pos;
 } filter;
 
+/**
+ * @brief returns true if param is valid for the kernel
+ */
+bool filter_kernel_valid(E_FILTER_KERNEL const kernel, uint8_t const param);
+
 /** 
- * @brief create a filter with the the size 'size' and initializes the values with the value 'init_value'
+ * @brief create a filter with the kernel and its parameter (see E_FILTER_KERNEL, an invalid parameter is limited to
+ * the valid range, an invalid kernel is a bypass) and initializes the values with the value 'init_value'
  */
-void init_filter(filter *f, uint8_t const size, uint16_t const init_value);
+void init_filter(filter *f, E_FILTER_KERNEL const kernel, uint8_t const param, uint16_t const init_value);
 
 /**
- * @brief adds the value val to the filter
+ * @brief adds the value val to the filter and calculates the filtered value, constant time
  */
 void filter_add_value(filter *f, uint16_t const val);
 
@@ -0,0 +1,94 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @author Alexander Entinger, BSc
+* @brief this module decodes the ibus frames of a flysky receiver
+* @file ibus.c
+*/
+
+#include "ibus.h"
+
+#include <avr/io.h>
+
+/*
+ * frame (32 bytes, 2.8 ms at 115200 baud, every 7 ms):
+ *   0x20 (length) | 0x40 (command) | 14 channels with 16 bit, little endian, in us | checksum, little endian
+ * checksum = 0xFFFF - sum of the first 30 bytes
+ */
+#define IBUS_FRAME_SIZE		(32)
+#define IBUS_LENGTH			(0x20)
+#define IBUS_COMMAND		(0x40)
+#define IBUS_CHECKSUM_IDX	(30)
+
+static uint8_t m_idx = 0; // index of the next byte within the frame
+
+/**
+ * @brief discards a partially received frame, the next frame starts with the next length byte
+ */
+static void ibus_reset() {
+	m_idx = 0;
+}
+
+/**
+ * @brief processes one received byte
+ */
+static E_SERIAL_FRAME ibus_parse(uint8_t const data, bool const gap) {
+	static uint16_t sum = 0;
+	
+	if(gap) m_idx = 0;
+	// hunt for the header
+	if(m_idx == 0) {
+		if(data != IBUS_LENGTH) return SERIAL_FRAME_INCOMPLETE;
+		sum = 0;
+	} else if(m_idx == 1 && data != IBUS_COMMAND) {
+		m_idx = 0;
+		return SERIAL_FRAME_ERROR;
+	}
+	serial_frame_buffer[m_idx] = data;
+	if(m_idx < IBUS_CHECKSUM_IDX) sum += data;
+	m_idx++;
+	if(m_idx < IBUS_FRAME_SIZE) return SERIAL_FRAME_INCOMPLETE;
+	
+	m_idx = 0;
+	uint16_t const checksum = ((uint16_t)(serial_frame_buffer[IBUS_CHECKSUM_IDX + 1]) << 8) | serial_frame_buffer[IBUS_CHECKSUM_IDX];
+	uint16_t const expected = 0xFFFF - sum;
+	if(checksum != expected) return SERIAL_FRAME_ERROR;
+	return SERIAL_FRAME_CHANNELS;
+}
+
+/**
+ * @brief copies the channels of the frame just completed in units of 4 us
+ */
+static uint8_t ibus_get_channels(uint16_t *channels) {
+	for(uint8_t ch = 0; ch < IBUS_NUM_CHANNELS; ch++) {
+		channels[ch] = (((uint16_t)(serial_frame_buffer[2 + 2 * ch + 1]) << 8) | serial_frame_buffer[2 + 2 * ch]) >> 2;
+	}
+	return 0; // ibus has no failsafe flag, the receiver stops sending or sends the failsafe values
+}
+
+serial_decoder const IBUS_DECODER PROGMEM = {
+	.baudrate = 115200,
+	.double_speed = true, // 2.1 % baudrate error instead of 3.5 %
+	.frame_format = (1<<UCSZ11) | (1<<UCSZ10), // 8 data bits, no parity, 1 stop bit
+	.num_channels = IBUS_NUM_CHANNELS,
+	.reset = ibus_reset,
+	.parse = ibus_parse,
+	.get_channels = ibus_get_channels
+};
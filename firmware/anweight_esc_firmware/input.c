@@ -24,112 +24,618 @@
 */
 
 #include "input.h"
+#include "serial_rx.h"
+#include "sbus.h"
+#include "ibus.h"
+#include "crsf.h"
+#include "dshot.h"
+#include "timebase.h"
 
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
 
 typedef enum {CH1 = 0, CH2 = 1} E_CHANNEL_SELECT;
 
-static volatile bool m_input_good = false; // signals if we have sufficient signals or not
+/**
+ * a pulse (pwm, fast pwm), a channel of a ppm frame or a dshot frame measured by an edge interrupt
+ */
+typedef struct input_sample {
+	uint8_t channel; // CH1 or CH2
+	uint16_t value; // in units of 4 us
+	uint16_t timestamp; // timer 1 at the end of the pulse or ppm channel or the start of the dshot frame in units of 4 us, wraps after 262 ms
+} input_sample;
+
+/*
+ * The edge interrupts only measure and push the samples into a ring buffer, the callbacks (filter, mapping,
+ * calibration) are executed by input_task in the main loop. The ring buffer has a single producer (the edge
+ * interrupts, which do not nest) and a single consumer (the main loop): the interrupts only write m_ring_head, the
+ * main loop only writes m_ring_tail, both are 8 bit so they are read and written atomically. A sample which finds the
+ * ring buffer full is dropped and counted. 16 samples last 1 ms with both channels at 8 kHz (fast pwm), the main loop
+ * drains the ring buffer every 0.2 ms at most (control_update once per ms).
+ */
+#define INPUT_RING_SIZE		(16) // power of 2
+
+// Timer 1 runs with tTimerStep = 62.5 ns, pulse durations are passed on in units of 4 us
+#define TIMER_TICKS_TO_4US_SHIFT	(6)
+#define TIMER_TICKS_PER_MS			(16000UL)
+
+static volatile E_INPUT_MODE m_input_mode = INPUT_PWM;
+static volatile uint16_t m_last_pulse_ms[2] = {0, 0}; // time of the last pulse of each channel
+static volatile uint8_t m_good_pulses[2] = {0, 0}; // pulses since the channel was lost, up to INPUT_RECOVERY_PULSES
+static volatile uint8_t m_timeout_ms = INPUT_DEFAULT_TIMEOUT_MS;
 static volatile E_EDGE_STATE m_ch_edge_state[2] = {RISING, RISING};
 static volatile callback_func m_ch_callback[2] = {0, 0};
-static volatile uint8_t m_pulse_cnt = 0; // pulse counter for determining signal loss
+static volatile frame_callback_func m_frame_callback = 0;
+static volatile uint16_t m_channel[INPUT_MAX_CHANNELS] = {0}; // last decoded value of each channel, in units of 4 us
+static serial_decoder m_decoder = {0}; // copy of the frame decoder of the serial protocols, parse is 0 for the other modes
+static input_stats m_stats = {0, 0, 0, 0, 0, {0, 0}};
+static volatile uint16_t m_timer_overflows = 0; // upper 16 bit of the timestamps
+static volatile uint8_t m_ppm_idx = PPM_MAX_CHANNELS; // channel of the next ppm edge, PPM_MAX_CHANNELS = wait for the sync gap
+static volatile uint16_t m_min_width = INPUT_DEFAULT_MIN_WIDTH_US >> 2; // limits of a valid pulse in units of 4 us
+static volatile uint16_t m_max_width = INPUT_DEFAULT_MAX_WIDTH_US >> 2;
+static volatile uint32_t m_min_period_ticks = INPUT_DEFAULT_MIN_PERIOD_MS * TIMER_TICKS_PER_MS; // limits of the frame period
+static volatile uint32_t m_max_period_ticks = INPUT_DEFAULT_MAX_PERIOD_MS * TIMER_TICKS_PER_MS;
+static volatile input_sample m_ring[INPUT_RING_SIZE]; // samples of the edge interrupts for input_task
+static volatile uint8_t m_ring_head = 0; // next entry written by the edge interrupts
+static volatile uint8_t m_ring_tail = 0; // next entry read by input_task
+
+// a ppm channel lasts 0.9 - 2.1 ms, the gap between two frames is at least 2.5 ms
+#define PPM_MIN_SYNC_TICKS			(40000UL) // 2.5 ms
+// 1 ms servo pulse in units of 4 us, the fast pwm pulses are scaled to 1 - 2 ms
+#define FAST_PWM_MIN_VALUE			(250)
+// 1.5 ms servo pulse in units of 4 us, the neutral position of dshot in 3d mode
+#define DSHOT_NEUTRAL_VALUE			(375)
+// a dshot150 frame is read with interrupts disabled for ~117 us, one frame per ms
+#define DSHOT_BLOCKING_LOAD			(117)
+// the fast pwm pulses and dshot frames are passed on at most once per ms, in units of 4 us of the sample timestamps
+#define INPUT_SAMPLE_UPDATE_TIME	(250)
+
+/**
+ * timing of a fast pwm protocol in timer ticks of 62.5 ns, a pulse between zero_ticks and zero_ticks + span_ticks is
+ * scaled to FAST_PWM_MIN_VALUE + ((ticks - zero_ticks) * mul) >> shift, pulses slightly outside are limited to the
+ * range, pulses outside of min_ticks - max_ticks are ignored (e.g. servo pulses with a wrong input mode configured)
+ */
+typedef struct fast_pwm_timing {
+	uint16_t min_ticks;
+	uint16_t zero_ticks;
+	uint16_t span_ticks;
+	uint16_t max_ticks;
+	uint8_t mul;
+	uint8_t shift;
+} fast_pwm_timing;
+
+// indexed by mode - INPUT_ONESHOT125, the scaling maps span_ticks to 250 steps
+static fast_pwm_timing const FAST_PWM_TIMING[3] PROGMEM = {
+	{1750, 2000, 2000, 4250, 1, 3}, // oneshot125: 125 - 250 us, 2000 ticks * 1 / 8 = 250
+	{584, 667, 666, 1416, 3, 3}, // oneshot42: 41.7 - 83.3 us, 666 ticks * 3 / 8 = 250
+	{40, 80, 320, 440, 25, 5} // multishot: 5 - 25 us, 320 ticks * 25 / 32 = 250
+};
+
+/*
+ * Measurement jitter
+ * ATmega32U2 has only one input capture unit (ICP1 = PC7), which drives the left h-bridge, so the receiver
+ * channels on INT0/INT1 are timestamped in software. The edge interrupts read TCNT1 first, so the fixed
+ * interrupt entry latency cancels out in the difference of both edges and only the time an edge interrupt is
+ * held back shows up as jitter. The pulse width error is the difference of the delays of both edges, then
+ * truncated to 4 us units.
+ * Before (callbacks executed within the edge interrupt with interrupts disabled):
+ *   callback of the other channel (filter + mapping, calibration) ~ 60 - 150 us, with a receiver which outputs the
+ *   channels one after another the rising edge of ch 2 coincides with the falling edge of ch 1, so ch 2 was
+ *   measured up to 150 us (37 LSB) too short
+ *   pwm interrupt incl. waiting for close edges        ~ 4 - 18 us
+ *   copy of the pwm schedule into the inactive buffer   ~ 7 us
+ *   timebase / overflow interrupt                       ~ 2 us
+ *   -> worst case ~ 170 us per edge
+ * Now (callbacks executed by the main loop, see input_task, short atomic sections in the pwm engine):
+ *   edge interrupt of the other channel                 ~ 4 us
+ *   pwm interrupt incl. waiting for close edges        ~ 4 - 18 us
+ *   timebase / overflow interrupt                       ~ 2 us
+ *   -> worst case ~ 20 us per edge, typically below one 4 us LSB as the pwm edges rarely coincide with the input edges
+ * The usb interrupts are only active while the esc is connected to the pc for configuration.
+ * The fast pwm protocols are scaled from the full timer resolution, a held back edge weighs more there: 4 us are
+ * 3 % of the oneshot125 range, 10 % of oneshot42 and 20 % of multishot, which is only usable while the motors are
+ * driven with a pwm of at most 4 kHz (few pwm interrupts) or with the receiver signals as the only interrupts.
+ */
+
+/**
+ * @brief returns true for the fast pwm protocols, they are read like servo pulses but passed on by input_task
+ */
+static inline bool is_fast_pwm(E_INPUT_MODE const mode) {
+	return (mode >= INPUT_ONESHOT125 && mode <= INPUT_MULTISHOT);
+}
+
+/**
+ * @brief returns true if the input carries digital values with an exact neutral position (dshot), the neutral position
+ * and the range of the channels need no calibration then
+ */
+bool input_is_digital() {
+	return (m_input_mode == INPUT_DSHOT150);
+}
+
+/**
+ * @brief returns the share of the cpu in permille during which the decoder of mode holds all other interrupts back
+ */
+uint16_t input_blocking_load(E_INPUT_MODE const mode) {
+	return (mode == INPUT_DSHOT150) ? DSHOT_BLOCKING_LOAD : 0;
+}
+
+/**
+ * @brief configures the external interrupts or the serial receiver for the input mode, called with interrupts disabled
+ */
+static void start_input_mode(E_INPUT_MODE const mode) {
+	m_input_mode = mode;
+	m_ch_edge_state[CH1] = RISING;
+	m_ch_edge_state[CH2] = RISING;
+	m_ppm_idx = PPM_MAX_CHANNELS;
+	m_ring_tail = m_ring_head;
+	m_good_pulses[CH1] = 0;
+	m_good_pulses[CH2] = 0;
+	// first we go for the rising edge, ppm is decoded from rising edge to rising edge
+	EICRA |= (1<<ISC01) | (1<<ISC00) | (1<<ISC11) | (1<<ISC10);
+	EIFR = (1<<INTF0) | (1<<INTF1);
+	// ppm uses only the ch 1 pin, the serial protocols the usart
+	serial_decoder const *decoder = 0;
+	if(mode == INPUT_SBUS) decoder = &SBUS_DECODER;
+	else if(mode == INPUT_IBUS) decoder = &IBUS_DECODER;
+	else if(mode == INPUT_CRSF) decoder = &CRSF_DECODER;
+	m_decoder.parse = 0;
+	if(decoder != 0) {
+		memcpy_P(&m_decoder, decoder, sizeof(m_decoder));
+		EIMSK &= ~((1<<INT0) | (1<<INT1));
+		m_decoder.reset();
+		enable_serial_rx(m_decoder.baudrate, m_decoder.double_speed, m_decoder.frame_format);
+	} else if(mode == INPUT_PPM) {
+		disable_serial_rx();
+		EIMSK = (EIMSK & ~(1<<INT1)) | (1<<INT0);
+	} else if(mode == INPUT_DSHOT150) {
+		// the channels are armed one at a time by input_task
+		disable_serial_rx();
+		EIMSK &= ~((1<<INT0) | (1<<INT1));
+	} else {
+		disable_serial_rx();
+		EIMSK |= (1<<INT0) | (1<<INT1);
+	}
+}
 
 /**
  * @brief initializes the input module
  */
-void init_input(callback_func cb_ch1, callback_func cb_ch2) {
+void init_input(E_INPUT_MODE const mode, callback_func cb_ch1, callback_func cb_ch2, frame_callback_func cb_frame) {
 	// register the callbacks
 	m_ch_callback[CH1] = cb_ch1;
 	m_ch_callback[CH2] = cb_ch2;
+	m_frame_callback = cb_frame;
 	
-	// ch1 input pin = PD0 (INT0)
+	// ch1 input pin = PD0 (INT0), also the ppm input
 	// ch2 input pin = PD1 (INT1)
 	DDRD &=  ~((1<<PORTD0) | (1<<PORTD1)); // set to input
 	PORTD |= (1<<PORTD0) | (1<<PORTD1); // activate pullup
 	
-	// first we go for the rising edge
-	EICRA |= (1<<ISC01) | (1<<ISC00) | (1<<ISC11) | (1<<ISC10);
+	// configure and enable the external interrupts
+	if(!set_input_mode(mode)) set_input_mode(INPUT_PWM);
 	
-	// enable the external interrupts
-	EIMSK |= (1<<INT0) | (1<<INT1);
+	// enable timer 1 overflow interrupt for the timestamps, timer 1 is started by the timebase with tTimerStep = 62.5 ns
+	TIMSK1 |= (1<<TOIE1);
+}
 
-	// set timer to zero
-	TCNT1 = 0;
-	
-	// enable timer 0 overflow interrupt
-	TIMSK1 = (1<<TOIE1);
-	
-	// Prescaler = 64, tTimerStep = 4 us
-	TCCR1B = (1<<CS11) | (1<<CS10);
+/**
+ * @brief changes the input signal type, decoding starts again with the next pulse (pwm) or frame (ppm)
+ * @return false if mode is not a valid input mode, nothing is changed then
+ */
+bool set_input_mode(E_INPUT_MODE const mode) {
+	if(mode > INPUT_DSHOT150) return false;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		start_input_mode(mode);
+	}
+	return true;
+}
+
+/**
+ * @brief sets the time without a pulse after which a channel is lost
+ * @return false if ms is shorter than INPUT_MIN_TIMEOUT_MS, the timeout is not changed then
+ */
+bool set_input_timeout(uint8_t const ms) {
+	if(ms < INPUT_MIN_TIMEOUT_MS) return false;
+	m_timeout_ms = ms;
+	return true;
+}
+
+/**
+ * @brief returns false if min_width_us < INPUT_MIN_WIDTH_US, max_width_us > INPUT_MAX_WIDTH_US, min_period_ms <
+ * INPUT_MIN_PERIOD_MS or a minimum is not below its maximum
+ */
+bool pulse_validation_valid(uint16_t const min_width_us, uint16_t const max_width_us, uint8_t const min_period_ms, uint8_t const max_period_ms) {
+	if(min_width_us < INPUT_MIN_WIDTH_US || max_width_us > INPUT_MAX_WIDTH_US || min_width_us >= max_width_us) return false;
+	if(min_period_ms < INPUT_MIN_PERIOD_MS || min_period_ms >= max_period_ms) return false;
+	return true;
+}
+
+/**
+ * @brief sets the limits of a valid pulse (pwm, ppm) and frame period (pwm), rejected pulses neither reach the
+ * callbacks nor count for input_good
+ */
+bool set_pulse_validation(uint16_t const min_width_us, uint16_t const max_width_us, uint8_t const min_period_ms, uint8_t const max_period_ms) {
+	if(!pulse_validation_valid(min_width_us, max_width_us, min_period_ms, max_period_ms)) return false;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		m_min_width = min_width_us >> 2;
+		m_max_width = max_width_us >> 2;
+		m_min_period_ticks = min_period_ms * TIMER_TICKS_PER_MS;
+		m_max_period_ticks = max_period_ms * TIMER_TICKS_PER_MS;
+	}
+	return true;
 }
 
 /** 
- * @brief returns if there were valid pulses in valid periods received
+ * @brief returns true if both channels had a pulse within the timeout and at least INPUT_RECOVERY_PULSES pulses since
+ * they were lost. The timeout is checked on every call, so the signal loss is detected at most 1 ms after the timeout
+ * when polled from the main loop, the measured time from the last pulse to the detection is kept in the statistics.
  */
 bool input_good() {
-	return m_input_good;
+	bool good = true;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		uint16_t const now = timebase_ms();
+		for(uint8_t ch = CH1; ch <= CH2; ch++) {
+			uint16_t const since_last_pulse = now - m_last_pulse_ms[ch];
+			if(m_good_pulses[ch] > 0 && since_last_pulse > m_timeout_ms) {
+				if(m_good_pulses[ch] >= INPUT_RECOVERY_PULSES) m_stats.failsafe_latency_ms = since_last_pulse;
+				m_good_pulses[ch] = 0;
+				// wait for a rising edge again (when new correct data starts to arrive) and for the next ppm frame
+				m_ch_edge_state[ch] = RISING;
+				EICRA |= (ch == CH1) ? ((1<<ISC01) | (1<<ISC00)) : ((1<<ISC11) | (1<<ISC10));
+				m_ppm_idx = PPM_MAX_CHANNELS;
+			}
+			if(m_good_pulses[ch] < INPUT_RECOVERY_PULSES) good = false;
+		}
+	}
+	return good;
+}
+
+/**
+ * @brief returns the number of valid pulses or frames of channel ch since the input mode was set or the channel was
+ * lost, up to INPUT_RECOVERY_PULSES
+ */
+uint8_t input_pulses(uint8_t const ch) {
+	if(ch > CH2) return 0;
+	return m_good_pulses[ch];
+}
+
+/**
+ * @brief stores the time of a pulse of channel ch, called with interrupts disabled
+ */
+static void pulse_received(E_CHANNEL_SELECT const ch) {
+	m_last_pulse_ms[ch] = timebase_ms();
+	if(m_good_pulses[ch] < INPUT_RECOVERY_PULSES) m_good_pulses[ch]++;
+}
+
+/**
+ * @brief returns the last decoded value of channel ch in units of 4 us, 0 if ch was not received (yet)
+ */
+uint16_t input_channel(uint8_t const ch) {
+	if(ch >= INPUT_MAX_CHANNELS) return 0;
+	uint16_t value = 0;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		value = m_channel[ch];
+	}
+	return value;
+}
+
+/**
+ * @brief passes a valid frame of a serial protocol on, a frame with the failsafe flag signals the signal loss at once,
+ * a frame with the frame lost flag only repeats old values and is ignored
+ */
+static void serial_frame() {
+	uint16_t channels[INPUT_MAX_CHANNELS];
+	uint8_t const flags = m_decoder.get_channels(channels);
+	if(flags & SERIAL_FLAG_FAILSAFE) {
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			m_good_pulses[CH1] = 0;
+			m_good_pulses[CH2] = 0;
+		}
+		return;
+	}
+	if(flags & SERIAL_FLAG_FRAME_LOST) return;
+	for(uint8_t ch = 0; ch < m_decoder.num_channels; ch++) m_channel[ch] = channels[ch];
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		pulse_received(CH1);
+		pulse_received(CH2);
+	}
+	(*m_frame_callback)(channels[CH1], channels[CH2]);
+}
+
+/**
+ * @brief takes the oldest sample of the edge interrupts from the ring buffer
+ * @return false if the ring buffer is empty
+ */
+static bool ring_get(input_sample *sample) {
+	uint8_t const tail = m_ring_tail;
+	if(tail == m_ring_head) return false;
+	*sample = m_ring[tail];
+	m_ring_tail = (tail + 1) & (INPUT_RING_SIZE - 1);
+	return true;
+}
+
+/**
+ * @brief passes the samples of the edge interrupts on to the callbacks. Pwm pulses are passed on one by one, ppm frames
+ * as soon as ch 2 is received. The fast pwm pulses and dshot frames of both channels are passed on at most once per ms
+ * of their timestamps, older values are dropped, as the slew limiters pass the requested speeds on to the motors with a
+ * tick of 1 ms anyway. The timestamps are taken by the edge interrupts, so the rate and the pairing of the channels do
+ * not depend on how late the main loop drains the ring buffer.
+ * @return number of samples of ch 1
+ */
+static uint8_t process_samples() {
+	static uint16_t latest[2] = {0, 0};
+	static uint16_t latest_time = 0; // timestamp of the latest sample of ch 1 (ppm) or of both channels (fast pwm, dshot)
+	static bool latest_pending = false;
+	static uint16_t last_update_time = 0;
+	
+	uint8_t ch1_samples = 0;
+	input_sample sample;
+	while(ring_get(&sample)) {
+		if(sample.channel == CH1) ch1_samples++;
+		if(m_input_mode == INPUT_PWM) {
+			(*(m_ch_callback[sample.channel]))(sample.value);
+		} else if(m_input_mode == INPUT_PPM) {
+			// ch 2 ends one channel width after ch 1 of the same frame, a ch 1 of an older frame (dropped samples) is not paired with it
+			if(sample.channel == CH2 && (uint16_t)(sample.timestamp - latest_time) <= sample.value + 1) (*m_frame_callback)(latest[CH1], sample.value);
+			else if(sample.channel == CH1) latest_time = sample.timestamp;
+			latest[sample.channel] = sample.value;
+		} else {
+			latest[sample.channel] = sample.value;
+			latest_time = sample.timestamp;
+			latest_pending = true;
+		}
+	}
+	if(latest_pending && (uint16_t)(latest_time - last_update_time) >= INPUT_SAMPLE_UPDATE_TIME) {
+		last_update_time = latest_time;
+		latest_pending = false;
+		(*m_frame_callback)(latest[CH1], latest[CH2]);
+	}
+	return ch1_samples;
+}
+
+/**
+ * @brief arms the edge interrupt of one channel per ms for reading a dshot frame, the flight controller sends the
+ * frames of both channels at the same time, so they are read alternately
+ */
+static void dshot_arm(uint16_t const now) {
+	static uint16_t last_arm_ms = 0;
+	
+	if(now == last_arm_ms) return;
+	last_arm_ms = now;
+	uint8_t const arm = (now & 1) ? (1<<INT1) : (1<<INT0);
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		EIFR = (1<<INTF0) | (1<<INTF1);
+		EIMSK = (EIMSK & ~((1<<INT0) | (1<<INT1))) | arm;
+	}
+}
+
+/**
+ * @brief decodes the bytes received from a serial receiver or passes the samples of the edge interrupts on to the
+ * callbacks, called from the main loop, the callbacks are only executed from here
+ */
+void input_task() {
+	static uint16_t rate_start_ms = 0;
+	static uint16_t frames = 0;
+	
+	uint16_t const now = timebase_ms();
+	if(m_decoder.parse != 0) {
+		uint8_t data = 0, flags = 0;
+		while(serial_rx_get(&data, &flags)) {
+			if(flags & SERIAL_RX_ERROR) {
+				m_stats.line_errors++;
+				m_decoder.reset();
+				continue;
+			}
+			E_SERIAL_FRAME const frame = m_decoder.parse(data, (flags & SERIAL_RX_GAP) != 0);
+			if(frame == SERIAL_FRAME_ERROR) {
+				m_stats.frame_errors++;
+			} else if(frame == SERIAL_FRAME_CHANNELS) {
+				frames++;
+				serial_frame();
+			}
+		}
+	} else {
+		if(m_input_mode == INPUT_DSHOT150) dshot_arm(now);
+		frames += process_samples();
+	}
+	
+	// frames with channels, pulses, ppm frames or dshot frames of ch 1 per second
+	if((uint16_t)(now - rate_start_ms) >= 1000) {
+		rate_start_ms = now;
+		m_stats.frame_rate = frames;
+		frames = 0;
+	}
+}
+
+/**
+ * @brief returns the frame or pulse rate, the error counters, the failsafe latency and the ring buffer overflows
+ */
+void input_get_stats(input_stats *stats) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		*stats = m_stats;
+	}
 }
 
 /** 
- * @brief timer 1 overflow interrupt, occurs every 262 ms
+ * @brief timer 1 overflow interrupt, occurs every 4.096 ms, counts the upper 16 bit of the timestamps
  */
 ISR(TIMER1_OVF_vect) {
-	// in 260 ms on one channel we should have 13 pulses
-	// so with two channels we should have 26 pulses, if we have significant less (lets say half)
-	// its fair to assume, that we have a signal loss,
-	uint8_t const MIN_PULSES = 22;
+	m_timer_overflows++;
+}
+
+/**
+ * @brief extends the timer value now read by an edge interrupt to 32 bit with the number of timer overflows,
+ * an overflow which is still pending belongs to now if now is in the lower half of the timer range
+ */
+static uint32_t extend_timestamp(uint16_t const now) {
+	uint16_t overflows = m_timer_overflows;
+	if((TIFR1 & (1<<TOV1)) && now < 0x8000) overflows++;
+	return ((uint32_t)(overflows) << 16) | now;
+}
+
+/**
+ * @brief stores a sample of channel ch in units of 4 us with its extended timestamp for input_task, called by the edge
+ * interrupts, a sample which finds the ring buffer full is dropped and counted
+ */
+static void push_sample(E_CHANNEL_SELECT const ch, uint16_t const value, uint32_t const timestamp) {
+	m_channel[ch] = value;
+	pulse_received(ch);
+	uint8_t const head = m_ring_head;
+	uint8_t const next = (head + 1) & (INPUT_RING_SIZE - 1);
+	if(next == m_ring_tail) {
+		m_stats.ring_overflows++;
+		return;
+	}
+	m_ring[head].channel = ch;
+	m_ring[head].value = value;
+	m_ring[head].timestamp = (uint16_t)(timestamp >> TIMER_TICKS_TO_4US_SHIFT);
+	m_ring_head = next;
+}
+
+/**
+ * @brief checks a pwm pulse of channel ch with the width in units of 4 us and the timestamp of its rising edge, called by
+ * the edge interrupts. Noise spikes are far shorter than a servo pulse, a spike within a pulse splits it into two short
+ * ones, a spike with a plausible width is caught by the frame period. A rejected pulse is counted, a pulse after more
+ * than the maximum frame period (the first one after a signal loss) only starts the period measurement again.
+ */
+static bool pwm_pulse_valid(E_CHANNEL_SELECT const ch, uint16_t const width, uint32_t const rise) {
+	static uint32_t last_rise[2] = {0, 0};
 	
-	if(m_pulse_cnt < MIN_PULSES) {
-		// set the flag that symbolizes good data to false
-		m_input_good = false;
-		// reset the states to wait for a rising edge again (when new correct data starts to arrive)
-		m_ch_edge_state[CH1] = RISING;
-		m_ch_edge_state[CH2] = RISING;
-		EICRA |= (1<<ISC01) | (1<<ISC00) | (1<<ISC11) | (1<<ISC10);
-	} else {
-		m_input_good = true;
+	if(width < m_min_width || width > m_max_width) {
+		m_stats.rejected_pulses[ch]++;
+		return false;
+	}
+	uint32_t const period = rise - last_rise[ch];
+	if(period < m_min_period_ticks) {
+		m_stats.rejected_pulses[ch]++;
+		return false;
+	}
+	last_rise[ch] = rise;
+	return (period <= m_max_period_ticks);
+}
+
+/**
+ * @brief scales a fast pwm pulse of channel ch to units of 4 us and stores it for input_task, called by the edge
+ * interrupts with now read at their start. No callback is executed here, so the interrupt load stays low at update rates of up to 8 kHz.
+ */
+static void fast_pwm_pulse(E_CHANNEL_SELECT const ch, uint16_t ticks, uint16_t const now) {
+	fast_pwm_timing const *timing = &FAST_PWM_TIMING[m_input_mode - INPUT_ONESHOT125];
+	if(ticks < pgm_read_word(&timing->min_ticks) || ticks > pgm_read_word(&timing->max_ticks)) {
+		m_stats.rejected_pulses[ch]++;
+		return;
+	}
+	uint16_t const zero_ticks = pgm_read_word(&timing->zero_ticks);
+	uint16_t const full_ticks = zero_ticks + pgm_read_word(&timing->span_ticks);
+	if(ticks < zero_ticks) ticks = zero_ticks;
+	else if(ticks > full_ticks) ticks = full_ticks;
+	push_sample(ch, FAST_PWM_MIN_VALUE + (((ticks - zero_ticks) * pgm_read_byte(&timing->mul)) >> pgm_read_byte(&timing->shift)), extend_timestamp(now));
+}
+
+/**
+ * @brief reads the dshot frame started by the rising edge of channel ch and scales the throttle to units of 4 us,
+ * called by the edge interrupts. The channel is disarmed after a frame, a frame caught in the middle is dropped and
+ * the channel stays armed for the next frame, input_task arms the other channel with the next ms.
+ */
+static void dshot_frame(E_CHANNEL_SELECT const ch, uint16_t const now) {
+	uint16_t throttle = 0;
+	E_DSHOT_FRAME const frame = dshot_read_frame((ch == CH1) ? (1<<PIND0) : (1<<PIND1), now, &DSHOT150_TIMING, &throttle);
+	EIFR = (ch == CH1) ? (1<<INTF0) : (1<<INTF1); // the edges of the frame which were read
+	if(frame == DSHOT_FRAME_INCOMPLETE) return;
+	EIMSK &= ~((ch == CH1) ? (1<<INT0) : (1<<INT1));
+	if(frame == DSHOT_FRAME_CRC_ERROR) {
+		m_stats.frame_errors++;
+		return;
+	}
+	// 3d mode, disarmed and commands stop the motor, 48 - 1047 is reverse and 1048 - 2047 forward from the neutral position
+	uint16_t value = DSHOT_NEUTRAL_VALUE;
+	if(throttle >= DSHOT_3D_FWD_THROTTLE) value = DSHOT_NEUTRAL_VALUE + ((throttle - DSHOT_3D_FWD_THROTTLE + 4) >> 3);
+	else if(throttle >= DSHOT_MIN_THROTTLE) value = DSHOT_NEUTRAL_VALUE - ((throttle - DSHOT_MIN_THROTTLE + 4) >> 3);
+	push_sample(ch, value, extend_timestamp(now));
+}
+
+/**
+ * @brief decodes a ppm sum signal, called on every rising edge of the ppm pin.
+ * The time between two rising edges is the value of one channel, a gap longer than PPM_MIN_SYNC_TICKS marks the
+ * start of a frame. input_task serves the frame callback as soon as ch 2 of a frame is decoded, so the latency is
+ * one frame for both channels. A frame with more than PPM_MAX_CHANNELS channels is dropped till the next sync gap.
+ */
+static void ppm_edge(uint16_t const now) {
+	static uint32_t last = 0;
+	uint32_t const timestamp = extend_timestamp(now);
+	uint32_t const ticks = timestamp - last;
+	last = timestamp;
+	
+	if(ticks >= PPM_MIN_SYNC_TICKS) {
+		m_ppm_idx = 0;
+		return;
+	}
+	if(m_ppm_idx >= PPM_MAX_CHANNELS) return;
+	
+	// a channel outside of the width limits drops the rest of the frame
+	uint16_t const value = (uint16_t)(ticks) >> TIMER_TICKS_TO_4US_SHIFT;
+	if(value < m_min_width || value > m_max_width) {
+		if(m_ppm_idx <= CH2) m_stats.rejected_pulses[m_ppm_idx]++;
+		m_ppm_idx = PPM_MAX_CHANNELS;
+		return;
 	}
-	// reset the pulse cnt
-	m_pulse_cnt = 0;
+	// only ch 1 and ch 2 are passed on, the other channels can be read with input_channel
+	if(m_ppm_idx <= CH2) push_sample((E_CHANNEL_SELECT)(m_ppm_idx), value, timestamp);
+	else m_channel[m_ppm_idx] = value;
+	m_ppm_idx++;
 }
 
 /**
- * @brief externe interrupt for ch 1
+ * @brief externe interrupt for ch 1 and ppm, the timer is read first so the timestamp only depends on the interrupt latency
  */
 ISR(INT0_vect) {
-	static uint16_t start = 0, stop = 0;
+	uint16_t const now = TCNT1; // measure the time
+	static uint16_t start = 0;
 	
-	if(m_ch_edge_state[CH1] == RISING) {
-		start = TCNT1; // measure the time
+	if(m_input_mode == INPUT_PPM) {
+		ppm_edge(now);
+	} else if(m_input_mode == INPUT_DSHOT150) {
+		dshot_frame(CH1, now);
+	} else if(m_ch_edge_state[CH1] == RISING) {
+		start = now;
 		EICRA &= ~(1<<ISC00); // now wait for falling edge
 		m_ch_edge_state[CH1] = FALLING; // switch state
 	} else if(m_ch_edge_state[CH1] == FALLING) {
-		stop = TCNT1; // measure the time
-		uint16_t const pulse_duration = stop - start; // calculate the difference
-		(*(m_ch_callback[CH1]))(pulse_duration);
-		m_pulse_cnt++;
-		EICRA |= (1<<ISC00); // now wait for falling edge
+		uint16_t const ticks = now - start; // calculate the difference
+		if(is_fast_pwm(m_input_mode)) {
+			fast_pwm_pulse(CH1, ticks, now);
+		} else {
+			uint32_t const timestamp = extend_timestamp(now);
+			if(pwm_pulse_valid(CH1, ticks >> TIMER_TICKS_TO_4US_SHIFT, timestamp - ticks)) push_sample(CH1, ticks >> TIMER_TICKS_TO_4US_SHIFT, timestamp);
+		}
+		EICRA |= (1<<ISC00); // now wait for rising edge
 		m_ch_edge_state[CH1] = RISING; // switch state
 	}
 }
 
 /**
- * @brief externe interrupt for ch 2
+ * @brief externe interrupt for ch 2, the timer is read first so the timestamp only depends on the interrupt latency
  */
 ISR(INT1_vect) {
-	static uint16_t start = 0, stop = 0;
+	uint16_t const now = TCNT1; // measure the time
+	static uint16_t start = 0;
 		
-	if(m_ch_edge_state[CH2] == RISING) {
-		start = TCNT1; // measure the time
+	if(m_input_mode == INPUT_DSHOT150) {
+		dshot_frame(CH2, now);
+	} else if(m_ch_edge_state[CH2] == RISING) {
+		start = now;
 		EICRA &= ~(1<<ISC10); // now wait for falling edge
 		m_ch_edge_state[CH2] = FALLING; // switch state
 	} else if(m_ch_edge_state[CH2] == FALLING) {
-		stop = TCNT1; // measure the time
-		uint16_t const pulse_duration = stop - start; // calculate the difference
-		(*(m_ch_callback[CH2]))(pulse_duration);
-		m_pulse_cnt++;
-		EICRA |= (1<<ISC10); // now wait for falling edge
+		uint16_t const ticks = now - start; // calculate the difference
+		if(is_fast_pwm(m_input_mode)) {
+			fast_pwm_pulse(CH2, ticks, now);
+		} else {
+			uint32_t const timestamp = extend_timestamp(now);
+			if(pwm_pulse_valid(CH2, ticks >> TIMER_TICKS_TO_4US_SHIFT, timestamp - ticks)) push_sample(CH2, ticks >> TIMER_TICKS_TO_4US_SHIFT, timestamp);
+		}
+		EICRA |= (1<<ISC10); // now wait for rising edge
 		m_ch_edge_state[CH2] = RISING; // switch state
 	}
 }
@@ -31,14 +31,124 @@
 
 typedef enum {RISING = 0, FALLING = 1} E_EDGE_STATE;
 typedef void (*callback_func)(uint16_t);
+typedef void (*frame_callback_func)(uint16_t, uint16_t);
+
+/**
+ * INPUT_PWM: one servo pulse per channel, ch 1 on PD0 (INT0), ch 2 on PD1 (INT1)
+ * INPUT_PPM: sum signal with up to PPM_MAX_CHANNELS channels on PD0 (INT0)
+ * INPUT_SBUS: sbus frames with 16 channels on RXD1 (PD2), the signal has to be inverted in hardware
+ * INPUT_IBUS: ibus frames with 14 channels on RXD1 (PD2)
+ * INPUT_CRSF: crsf frames with 16 channels on RXD1 (PD2) at 400000 baud
+ * INPUT_ONESHOT125: 125 - 250 us pulses, INPUT_ONESHOT42: 42 - 84 us pulses, INPUT_MULTISHOT: 5 - 25 us pulses,
+ * on the same pins as INPUT_PWM with update rates of up to 8 kHz (fast pwm of flight controllers)
+ * INPUT_DSHOT150: crc checked dshot150 frames (3d mode) on the same pins as INPUT_PWM, no calibration needed
+ * PPM, the serial protocols, the fast pwm protocols and dshot pass the first two channels on together
+ * INPUT_AUTO: configuration value only, the input mode is detected at boot (see input_detect.h)
+ */
+typedef enum {INPUT_PWM = 0, INPUT_PPM = 1, INPUT_SBUS = 2, INPUT_IBUS = 3, INPUT_CRSF = 4, INPUT_ONESHOT125 = 5, INPUT_ONESHOT42 = 6, INPUT_MULTISHOT = 7, INPUT_DSHOT150 = 8, INPUT_AUTO = 9} E_INPUT_MODE;
+
+/**
+ * statistics of the input
+ */
+typedef struct input_stats {
+	uint16_t frame_rate; // valid frames with channels per second (serial protocols), pulses, ppm frames or dshot frames of ch 1 per second (other modes)
+	uint16_t frame_errors; // frames with a wrong checksum, crc or framing (serial protocols, dshot)
+	uint16_t line_errors; // bytes with framing, parity or overrun errors and bytes lost since the ring buffer was full (serial protocols)
+	uint16_t failsafe_latency_ms; // time from the last pulse to the detection of the last signal loss
+	uint16_t ring_overflows; // samples of the edge interrupts dropped since the main loop did not take them in time
+	uint16_t rejected_pulses[2]; // pulses of ch 1 and 2 outside of the valid width or frame period (pwm, ppm) or the pulse range (fast pwm)
+} input_stats;
+
+#define INPUT_MAX_CHANNELS	(16)
+#define PPM_MAX_CHANNELS	(8)
+
+// a channel is lost if it had no pulse for the timeout, 60 ms = 3 frames of a 50 Hz receiver
+#define INPUT_DEFAULT_TIMEOUT_MS	(60)
+#define INPUT_MIN_TIMEOUT_MS		(20)
+// a lost channel is good again after this number of pulses
+#define INPUT_RECOVERY_PULSES		(3)
+
+// a pwm pulse or ppm channel outside of the width limits is rejected, so is a pwm pulse whose rising edge follows the
+// previous one of the channel closer than the minimum frame period, a pulse after more than the maximum frame period
+// is not passed on either but starts the period measurement again
+#define INPUT_DEFAULT_MIN_WIDTH_US	(800)
+#define INPUT_DEFAULT_MAX_WIDTH_US	(2200)
+#define INPUT_DEFAULT_MIN_PERIOD_MS	(3)
+#define INPUT_DEFAULT_MAX_PERIOD_MS	(40)
+#define INPUT_MIN_WIDTH_US			(500)
+#define INPUT_MAX_WIDTH_US			(2500)
+#define INPUT_MIN_PERIOD_MS			(2)
 
 /**
  * @brief initializes the input module
+ * @param mode input signal type, INPUT_PWM is used if mode is not valid
+ * @param cb_ch1, cb_ch2 called with the pulse duration of channel 1/2 in units of 4 us (pwm)
+ * @param cb_frame called with channel 1 and 2 of a frame in units of 4 us (ppm, serial protocols), the fast pwm
+ * protocols and dshot are scaled to the 1 - 2 ms range of a servo pulse
+ */
+void init_input(E_INPUT_MODE const mode, callback_func cb_ch1, callback_func cb_ch2, frame_callback_func cb_frame);
+
+/**
+ * @brief changes the input signal type, decoding starts again with the next pulse (pwm) or frame (ppm, serial protocols),
+ * both channels have to receive INPUT_RECOVERY_PULSES pulses again until the input is good
+ * @return false if mode is not a valid input mode (also INPUT_AUTO), nothing is changed then
+ */
+bool set_input_mode(E_INPUT_MODE const mode);
+
+/**
+ * @brief decodes the bytes received from a serial receiver or passes the samples of the edge interrupts on to the
+ * callbacks, called from the main loop, the callbacks are only executed from here
  */
-void init_input(callback_func cb_ch1, callback_func cb_ch2);
+void input_task();
+
+/**
+ * @brief returns the frame or pulse rate, the error counters, the failsafe latency and the ring buffer overflows
+ */
+void input_get_stats(input_stats *stats);
+
+/**
+ * @brief returns the last decoded value of channel ch in units of 4 us, 0 if ch was not received (yet)
+ */
+uint16_t input_channel(uint8_t const ch);
 	
+/**
+ * @brief returns true if the input carries digital values with an exact neutral position (dshot), the neutral position
+ * and the range of the channels need no calibration then
+ */
+bool input_is_digital();
+
+/**
+ * @brief returns the share of the cpu in permille during which the decoder of mode holds all other interrupts back
+ */
+uint16_t input_blocking_load(E_INPUT_MODE const mode);
+
+/**
+ * @brief sets the time without a pulse after which a channel is lost
+ * @return false if ms is shorter than INPUT_MIN_TIMEOUT_MS, the timeout is not changed then
+ */
+bool set_input_timeout(uint8_t const ms);
+
+/**
+ * @brief returns false if min_width_us < INPUT_MIN_WIDTH_US, max_width_us > INPUT_MAX_WIDTH_US, min_period_ms <
+ * INPUT_MIN_PERIOD_MS or a minimum is not below its maximum
+ */
+bool pulse_validation_valid(uint16_t const min_width_us, uint16_t const max_width_us, uint8_t const min_period_ms, uint8_t const max_period_ms);
+
+/**
+ * @brief sets the limits of a valid pulse (pwm, ppm) and frame period (pwm), rejected pulses neither reach the
+ * callbacks nor count for input_good
+ * @return false if the limits are not valid (see pulse_validation_valid), the limits are not changed then
+ */
+bool set_pulse_validation(uint16_t const min_width_us, uint16_t const max_width_us, uint8_t const min_period_ms, uint8_t const max_period_ms);
+
+/**
+ * @brief returns the number of valid pulses or frames of channel ch since the input mode was set or the channel was
+ * lost, up to INPUT_RECOVERY_PULSES
+ */
+uint8_t input_pulses(uint8_t const ch);
+
 /** 
- * @brief returns if there were valid pulses in valid periods received
+ * @brief returns true if both channels had a pulse within the timeout, checked on every call
  */
 bool input_good();	
 
@@ -0,0 +1,119 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @author Alexander Entinger, BSc
+ * @brief this file implements the detection of the input signal type at boot
+ * @file input_detect.c
+ */
+
+#include "input_detect.h"
+#include "timebase.h"
+
+#include <avr/pgmspace.h>
+
+/*
+ * The input modes are tried one after another with the decoders of the input module, a mode is detected when both
+ * channels received the number of valid pulses or frames of the candidate within its window. The windows are as short
+ * as the frame period allows: a pwm pulse needs the previous one as reference of the frame period (2 frames of 20 ms),
+ * ppm a sync gap and one frame of 22.5 ms, the serial protocols a gap and one frame. The checks of the decoders keep
+ * the modes apart: dshot has a crc, the ranges of the fast pwm protocols and the servo pulses do not overlap, a pwm
+ * signal has no sync gap for ppm, ppm has no pulses on the ch 2 pin, the serial protocols run with different baud
+ * rates and frame formats and have checksums. Dshot is tried before multishot, which could take its bits for pulses.
+ */
+
+/**
+ * an input mode to try, with the time it is tried and the pulses or frames needed on each channel
+ */
+typedef struct detect_candidate {
+	E_INPUT_MODE mode;
+	uint8_t window_ms;
+	uint8_t pulses;
+} detect_candidate;
+
+#define DETECT_CANDIDATES_NUM	(9)
+
+// the sum of the windows is INPUT_DETECT_SWEEP_MS, the fast pwm protocols and dshot are expected with at least 1 kHz
+static detect_candidate const DETECT_CANDIDATES[DETECT_CANDIDATES_NUM] PROGMEM = {
+	{INPUT_DSHOT150, 6, 2}, // the channels are read alternately each ms
+	{INPUT_MULTISHOT, 5, 2},
+	{INPUT_ONESHOT42, 5, 2},
+	{INPUT_ONESHOT125, 5, 2},
+	{INPUT_CRSF, 25, 1}, // 50 - 500 Hz
+	{INPUT_IBUS, 20, 1}, // 7 ms
+	{INPUT_SBUS, 35, 1}, // 7 or 14 ms
+	{INPUT_PPM, 50, 1}, // 22.5 ms
+	{INPUT_PWM, 45, 1} // 20 ms
+};
+
+// the candidates point into DETECT_CANDIDATES in flash
+static detect_candidate const *m_cached = 0; // candidate of the mode detected at the last boot, tried first
+static detect_candidate const *m_candidate = 0; // candidate currently tried
+static uint8_t m_step = 0; // next step of the sweep, 0 = m_cached, 1 - DETECT_CANDIDATES_NUM = DETECT_CANDIDATES
+static uint16_t m_max_blocking_load = 0; // candidates whose decoder blocks the pwm interrupt longer are skipped
+static uint16_t m_window_start_ms = 0;
+
+/**
+ * @brief switches the input module to the next candidate of the sweep, the cached one is only tried at its start
+ */
+static void next_candidate() {
+	for(;;) {
+		bool const first = (m_step == 0);
+		detect_candidate const *candidate = first ? m_cached : &DETECT_CANDIDATES[m_step - 1];
+		m_step = (m_step < DETECT_CANDIDATES_NUM) ? (m_step + 1) : 0;
+		if(candidate == 0 || (!first && candidate == m_cached)) continue;
+		E_INPUT_MODE const mode = (E_INPUT_MODE)(pgm_read_byte(&candidate->mode));
+		if(input_blocking_load(mode) > m_max_blocking_load) continue;
+		m_candidate = candidate;
+		m_window_start_ms = timebase_ms();
+		set_input_mode(mode);
+		return;
+	}
+}
+
+/**
+ * @brief starts the detection of the input mode with cached_mode, the mode detected at the last boot (INPUT_AUTO if
+ * none), then tries all other modes and starts over until a signal is found. Modes whose decoder holds the other
+ * interrupts back for more than max_blocking_load (permille of the cpu) are skipped
+ */
+void start_input_detection(E_INPUT_MODE const cached_mode, uint16_t const max_blocking_load) {
+	m_max_blocking_load = max_blocking_load;
+	m_cached = 0;
+	for(uint8_t i = 0; i < DETECT_CANDIDATES_NUM; i++) {
+		if(pgm_read_byte(&DETECT_CANDIDATES[i].mode) == cached_mode) m_cached = &DETECT_CANDIDATES[i];
+	}
+	m_step = 0;
+	next_candidate();
+}
+
+/**
+ * @brief switches to the next input mode when the window of the current one is over, called from the main loop after
+ * input_task
+ * @return true if the current input mode received valid pulses or frames on both channels
+ */
+bool input_detect_task(E_INPUT_MODE *mode) {
+	if(m_candidate == 0) return false;
+	uint8_t const pulses = pgm_read_byte(&m_candidate->pulses);
+	if(input_pulses(0) >= pulses && input_pulses(1) >= pulses) {
+		*mode = (E_INPUT_MODE)(pgm_read_byte(&m_candidate->mode));
+		return true;
+	}
+	if((uint16_t)(timebase_ms() - m_window_start_ms) >= pgm_read_byte(&m_candidate->window_ms)) next_candidate();
+	return false;
+}
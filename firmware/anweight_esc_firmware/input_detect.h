@@ -0,0 +1,50 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @author Alexander Entinger, BSc
+ * @brief this file implements the detection of the input signal type at boot
+ * @file input_detect.h
+ */
+
+#ifndef INPUT_DETECT_H_
+#define INPUT_DETECT_H_
+
+#include <stdbool.h>
+#include "input.h"
+
+// a sweep over all input modes takes 196 ms, a present signal is found within one sweep
+#define INPUT_DETECT_SWEEP_MS	(196)
+
+/**
+ * @brief starts the detection of the input mode with cached_mode, the mode detected at the last boot (INPUT_AUTO if
+ * none), then tries all other modes and starts over until a signal is found. Modes whose decoder holds the other
+ * interrupts back for more than max_blocking_load (permille of the cpu) are skipped
+ */
+void start_input_detection(E_INPUT_MODE const cached_mode, uint16_t const max_blocking_load);
+
+/**
+ * @brief switches to the next input mode when the window of the current one is over, called from the main loop after
+ * input_task
+ * @return true if the current input mode received valid pulses or frames on both channels, mode is set to it then and
+ * the input module keeps decoding it
+ */
+bool input_detect_task(E_INPUT_MODE *mode);
+
+#endif /* INPUT_DETECT_H_ */
@@ -25,6 +25,10 @@
 
 #include "linear_mapper.h"
 
+// fractional bits of k
+#define LINEAR_MAPPER_SHIFT		(16)
+#define LINEAR_MAPPER_HALF		((int32_t)(1) << (LINEAR_MAPPER_SHIFT - 1))
+
 /**
  * @brief initializes the linear mapper
  * @param lm the linear mapper ADT (abstract data type)
@@ -34,35 +38,36 @@
  * @param output_max maximum output value
  */
 void init_linear_mapper(linear_mapper *lm, int16_t const input_min, int16_t const input_max, int16_t const output_min, int16_t const output_max) {
-	int32_t const delta_input = ((int32_t)(input_max) - (int32_t)(input_min)) << 8;
-	int32_t const delta_output = ((int32_t)(output_max) - (int32_t)(output_min)) << 8;
+	int32_t const delta_input = (int32_t)(input_max) - (int32_t)(input_min);
+	int32_t const delta_output = ((int32_t)(output_max) - (int32_t)(output_min)) << LINEAR_MAPPER_SHIFT;
 	
-	lm->k = (int32_t)
-		(
-			delta_output
-			/ 
-			delta_input
-		); // multiplication by 16 for increasing accuracy in the mapping function
-	lm->d = (int32_t)
-		(
-			(int32_t)(output_max)
-			- 
-			(
-				lm->k * (int32_t)(input_max)
-			)
-		);
+	lm->input_min = input_min;
+	lm->input_max = input_max;
+	lm->output_min = output_min;
+	lm->k = 0;
+	if(delta_input == 0) return;
+	// k rounded to the nearest value, the division truncates towards zero so it is done with the magnitudes
+	uint32_t const abs_input = (delta_input < 0) ? -delta_input : delta_input;
+	uint32_t const abs_output = (delta_output < 0) ? -delta_output : delta_output;
+	int32_t const k = (int32_t)((abs_output + (abs_input >> 1)) / abs_input);
+	lm->k = ((delta_input < 0) != (delta_output < 0)) ? -k : k;
 }
 
 /**
- * @brief performs the linear mapping 
+ * @brief performs the linear mapping, the input is limited to the input range first, so k * (value - input_min) stays
+ * within output_max - output_min in q16.16 and fits into 32 bit
  * @param value input value to be mapped to output value
  * @return mapped output value
  */
 int16_t linear_map(linear_mapper *lm, int16_t const value) {
-	return (int16_t)
-			(
-			(lm->k * (int32_t)(value))
-			+
-			lm->d
-			);
+	int16_t input = value;
+	if(lm->input_min <= lm->input_max) {
+		if(input < lm->input_min) input = lm->input_min;
+		else if(input > lm->input_max) input = lm->input_max;
+	} else {
+		if(input > lm->input_min) input = lm->input_min;
+		else if(input < lm->input_max) input = lm->input_max;
+	}
+	// rounded to the nearest integer, the arithmetic shift rounds towards minus infinity
+	return (int16_t)(lm->output_min + ((lm->k * (int16_t)(input - lm->input_min) + LINEAR_MAPPER_HALF) >> LINEAR_MAPPER_SHIFT));
 }
\ No newline at end of file
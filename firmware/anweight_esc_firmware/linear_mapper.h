@@ -28,10 +28,12 @@
 
 #include <stdint.h>
 
-// definition of adt linear_mapper
+// definition of adt linear_mapper, output = output_min + k * (input - input_min) with k in fixed point with 16 fractional bits (q16.16)
 typedef struct linear_mapper {
 	int32_t k;
-	int32_t d;
+	int16_t input_min; // the input is limited to the range input_min - input_max (also with input_min > input_max)
+	int16_t input_max;
+	int16_t output_min;
 } linear_mapper;
 
 /**
@@ -40,14 +42,15 @@ typedef struct linear_mapper {
  * @param input_min minimum value of the input
  * @param input_max maximum value of the input
  * @param output_min minimum output value
- * @param output_max maximum output value
+ * @param output_max maximum output value, output_max - output_min and input_max - input_min have to fit into int16_t,
+ * an empty input range maps every input to output_min
  */
 void init_linear_mapper(linear_mapper *lm, int16_t const input_min, int16_t const input_max, int16_t const output_min, int16_t const output_max);
 
 /**
  * @brief performs the linear mapping 
- * @param value input value to be mapped to output value
- * @return mapped output value
+ * @param value input value to be mapped to output value, limited to the input range
+ * @return mapped output value, rounded to the nearest integer
  */
 int16_t linear_map(linear_mapper *lm, int16_t const value);
 
@@ -28,9 +28,11 @@
 #include <stdbool.h>
 #include "motor_control.h"
 #include "input.h"
+#include "input_detect.h"
 #include "control.h"
 #include "config.h"
 #include "status_led.h"
+#include "timebase.h"
 #include "VirtualSerial/VirtualSerial.h"
 
 // configuration structure
@@ -55,8 +57,19 @@ int main(void) {
 	
 		switch(firmware_state) {
 			case INIT: {
+				// with INPUT_AUTO the input modes are tried, starting with the one detected at the last boot
+				bool detecting = (configuration.input_mode == INPUT_AUTO);
+				if(detecting) start_input_detection(configuration.input_mode_detected, pwm_spare_load());
 				while(!input_good()) {
 					// wait until we have a good signal
+					// decode the serial receiver protocols
+					input_task();
+					// lock onto the detected input mode, it is read back with the configuration and cached for the next boot
+					E_INPUT_MODE detected_mode = INPUT_AUTO;
+					if(detecting && input_detect_task(&detected_mode)) {
+						detecting = false;
+						config_store_detected_input_mode(detected_mode);
+					}
 					// do the usb task necessary for working the usb
 					virtual_serial_task();
 					// if we have data available, switch the firmware state to go to config mode
@@ -72,30 +85,45 @@ int main(void) {
 			case CALIBRATION: {
 				// now do the calibration, set the config flag
 				do_calibration_of_neutral_position = true;
+				uint16_t last_tick = timebase_ms();
 				while(do_calibration_of_neutral_position) {
-					// wait for calibration to be done
+					// wait for calibration to be done, it is performed by the control tick with the next input values
+					input_task();
+					if(timebase_ms() != last_tick) {
+						last_tick++;
+						control_tick();
+					}
 				}
 				// and switch over to avtive state
 				firmware_state = ACTIVE;
 			} break;
 			case ACTIVE: {
 				// the input signals are switch to the output signals depending on the driving mode (tank or v mixer)
-				// monitor the signals, if there are no pulses on both channels for 5 periods switch to failsafe mode
+				// monitor the signals, if there is no pulse on a channel for the input timeout switch to failsafe mode
 				enable_motors();
 				// turn on status led to signalize operation
 				status_led_turn_on();
+				uint16_t last_tick = timebase_ms();
 				while(input_good()) {
-					// do the control stuff here, since its interrupt controlled nothing to do here anymore
+					input_task();
+					// the input values are filtered on arrival, the requested speeds and the slew limiting run with a fixed tick of 1 ms
+					if(timebase_ms() != last_tick) {
+						last_tick++;
+						control_tick();
+					}
 				}
 				firmware_state = FAILSAFE; // input channels are bad, switch to failsafe
 			} break;
 			case FAILSAFE: {
 				// we are in failsafe, so switch of the output channels
 				disable_motors();
+				// start again from zero speed when the signals are back
+				control_reset();
 				// also turn off status led to signal that we are not in active state anylonger
 				status_led_turn_off();
 				while(!input_good()) {
 					// wait until the signals are back up, if thats the case switch back to active
+					input_task();
 				}
 				firmware_state = ACTIVE;
 			} break;
@@ -103,6 +131,8 @@ int main(void) {
 				// do the config, no disabling of the motors needed, since they are not yet enabled
 				bool config_done = false;
 				do {
+					// keep taking the input samples, the motors are not enabled yet
+					input_task();
 					// do the usb task necessary for working the usb
 					virtual_serial_task();
 					// read from usb, change the settings according to that and send the requests answers
@@ -139,14 +169,26 @@ void init_application() {
 	// load parameters from EEPROM
 	init_config();
 	
+	// initialize the timebase
+	init_timebase();
+	
 	// initialize motor control
-	init_motor_control();
+	init_motor_control(configuration.pwm_frequency, configuration.pwm_phase, configuration.pwm_dithering, configuration.aux_channel != 0);
+	set_drive_mode(OUTPUT_LEFT, configuration.drive_mode_motor_left);
+	set_drive_mode(OUTPUT_RIGHT, configuration.drive_mode_motor_right);
+	if(!set_reversal_dead_time(configuration.reversal_dead_time_us)) set_reversal_dead_time(MAX_REVERSAL_DEAD_TIME_US);
 	
 	// init the contro module
 	init_control();
 	
 	// initialize the input module and register the callbacks
-	init_input(control_ch1_data_callback, control_ch2_data_callback);
+	init_input(configuration.input_mode, control_ch1_data_callback, control_ch2_data_callback, control_frame_data_callback);
+	// a decoder holding the pwm interrupt back longer than the pwm mode allows falls back to the slowest pwm mode
+	if(input_blocking_load(configuration.input_mode) > pwm_spare_load()) set_pwm_mode(PWM_1KHZ, PWM_IN_PHASE, false, configuration.aux_channel != 0);
+	if(!set_input_timeout(configuration.input_timeout_ms)) set_input_timeout(INPUT_DEFAULT_TIMEOUT_MS);
+	if(!set_pulse_validation(configuration.pulse_min_width_us, configuration.pulse_max_width_us, configuration.frame_period_min_ms, configuration.frame_period_max_ms)) {
+		set_pulse_validation(INPUT_DEFAULT_MIN_WIDTH_US, INPUT_DEFAULT_MAX_WIDTH_US, INPUT_DEFAULT_MIN_PERIOD_MS, INPUT_DEFAULT_MAX_PERIOD_MS);
+	}
 	
 	// initialize the virtual serial
 	init_virtual_serial();
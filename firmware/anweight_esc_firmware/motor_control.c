@@ -27,48 +27,282 @@
 
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+
+// ports with output pins, every edge of the pwm schedule carries the state of the output pins of each of them.
+// The aux output is the last channel of the channel table and the only one on the last port, while it is disabled
+// neither its edges nor its reversal bookkeeping are computed and the pwm interrupt does not write its port
+typedef enum {OUTPUT_PORT_B = 0, OUTPUT_PORT_C = 1, OUTPUT_PORT_D = 2} E_OUTPUT_PORT;
+#define NUM_OUTPUT_PORTS	(3)
+
+typedef struct {
+	volatile uint8_t *port;
+	volatile uint8_t *ddr;
+} s_output_port;
+
+static s_output_port const OUTPUT_PORT[NUM_OUTPUT_PORTS] = {
+	{&PORTB, &DDRB},
+	{&PORTC, &DDRC},
+	{&PORTD, &DDRD},
+};
+
+// pin mapping of an output channel, a motor is driven by setting pin a (forward) or pin b (backward) high.
+// The channel table is kept in flash, the port table stays in ram as the pwm interrupt reads it on every edge
+typedef struct {
+	E_OUTPUT_PORT port;
+	uint8_t pin_a; // mask of pin a
+	uint8_t pin_b; // mask of pin b, 0 for a single ended output which ignores the direction and the drive mode
+} s_output_channel;
+
+static s_output_channel const OUTPUT_CHANNEL[NUM_OUTPUT_CHANNELS] PROGMEM = {
+	{OUTPUT_PORT_C, (1<<6), (1<<7)}, // left motor: A = PC6, B = PC7
+	{OUTPUT_PORT_B, (1<<5), (1<<4)}, // right motor: A = PB5, B = PB4
+	{OUTPUT_PORT_D, (1<<7), 0}, // aux output: PD7 on the spare connector
+};
+
+typedef struct {
+	E_MOTOR_DIRECTION dir;
+	uint16_t speed;
+	E_MOTOR_DRIVE_MODE mode;
+} s_output;
+
+// one edge of the pwm schedule, the schedule is walked through by a single interrupt service routine
+typedef struct {
+	uint16_t tick; // timer ticks after the start of the period at which the edge is applied
+	uint8_t port[NUM_OUTPUT_PORTS]; // state of the output pins of each port from this edge on
+	uint8_t frac; // fractional part of tick in 1/256 ticks, the edge is delayed by one tick whenever its dithering accumulator overflows
+} s_pwm_edge;
 
 static volatile E_MOTOR_STATE m_motor_state = DISABLED;
-static volatile E_MOTOR_DIRECTION m_motor_left_dir = FWD;
-static volatile E_MOTOR_DIRECTION m_motor_right_dir = FWD;
+static s_output m_output[NUM_OUTPUT_CHANNELS] = {{FWD, 0, COAST}};
+// output pins of each port, collected from OUTPUT_CHANNEL
+static uint8_t m_output_port_mask[NUM_OUTPUT_PORTS] = {0};
+// channels and ports in use, NUM_OUTPUT_CHANNELS and NUM_OUTPUT_PORTS with the aux output, one less each without it
+static uint8_t m_num_channels = NUM_OUTPUT_CHANNELS - 1;
+static uint8_t m_num_ports = NUM_OUTPUT_PORTS - 1;
+
+// in phase: period start + one switch off edge per channel
+#define PWM_EDGES_IN_PHASE(channels)	(1 + (channels))
+// interleaved: additionally the switch on edge of the right motor
+#define PWM_EDGES_INTERLEAVED(channels)	(2 + (channels))
+// the first period after an update additionally carries the wrapped switch off edge of the previous schedule
+#define PWM_MAX_EDGES		(PWM_EDGES_INTERLEAVED(NUM_OUTPUT_CHANNELS) + 1)
+// estimated cpu cycles of one run of the pwm interrupt including prologue and epilogue, without writing the ports
+#define PWM_ISR_CYCLES		(35)
+// estimated cpu cycles for writing the output pins of one port per run of the pwm interrupt
+#define PWM_PORT_CYCLES		(15)
+// estimated additional cpu cycles of the reversal bookkeeping per channel at the start of a period
+#define PWM_PERIOD_START_CYCLES	(15)
+// estimated additional cpu cycles of the dithering per edge after the period start (one accumulator per edge)
+#define PWM_DITHER_CYCLES	(16)
+// maximum share of the cpu the pwm interrupt may take in permille
+#define PWM_MAX_CPU_LOAD	(300)
+
+// the pwm runs on output compare b of Timer 1, which runs free with tTimerStep = 62.5 ns (prescaler 1) and is shared
+// with the timebase (output compare a) and the input module. Each edge is scheduled relative to the start of its period.
+// minimum distance in ticks (2 us) for rearming the compare unit, closer edges are applied within the running interrupt service routine
+#define PWM_MIN_EDGE_GAP	(32)
+
+typedef struct {
+	uint16_t period_ticks;
+} s_pwm_setting;
+
+// Timer 1: f = 16 MHz, fPWM = 16 MHz / period_ticks, the resolution of the duty cycle is period_ticks steps
+static s_pwm_setting const PWM_SETTING[] PROGMEM = {
+	{16000}, // 1 kHz, 14 bit
+	{4000}, // 4 kHz, 12 bit
+	{2000}, // 8 kHz, 11 bit
+	{1000}, // 16 kHz, 10 bit
+	{800}, // 20 kHz, 9.6 bit
+};
+#define PWM_NUM_SETTINGS	(sizeof(PWM_SETTING) / sizeof(PWM_SETTING[0]))
+
+static uint16_t m_pwm_period_ticks = 16000;
+static uint16_t m_pwm_load = 0; // estimated load of the pwm interrupt in the running pwm mode in permille
+// speed to ticks factor, ticks = (speed * m_pwm_ticks_per_speed) >> 16
+static uint32_t m_pwm_ticks_per_speed = 0;
+// ticks after the period start at which the on time of each channel starts
+static uint16_t m_pwm_on_tick[NUM_OUTPUT_CHANNELS] = {0};
+static bool m_pwm_dithering = false;
+
+// on time of a channel which starts at its on tick in a period, it ends in the next period if it wraps around its end.
+// The pins are driven according to drive during the on time, the off time follows the drive mode of the latest update
+typedef struct {
+	uint16_t ticks;
+	uint8_t frac; // fractional part of ticks with dithering
+	uint8_t drive; // direction + 1 in which the channel is driven, 0 if it is not driven
+	uint8_t dead_periods; // periods the channel needs to stay undriven after this period before it may be driven in the opposite direction
+} s_pwm_window;
 
-#define MOTOR_LEFT_A_PIN	(6)
-#define MOTOR_LEFT_A_DDR	(DDRC)
-#define MOTOR_LEFT_A_PORT	(PORTC)
-#define MOTOR_LEFT_B_PIN	(7)
-#define MOTOR_LEFT_B_DDR	(DDRC)
-#define MOTOR_LEFT_B_PORT	(PORTC)
+typedef struct {
+	s_pwm_edge edge[PWM_MAX_EDGES];
+	uint8_t num_edges;
+	s_pwm_window window[NUM_OUTPUT_CHANNELS]; // on time of each channel starting in this period
+	uint8_t tail_drive[NUM_OUTPUT_CHANNELS]; // direction + 1 of the on time of the previous period wrapping into this one, 0 if none
+} s_pwm_schedule;
 
-#define MOTOR_RIGHT_A_PIN	(5)
-#define MOTOR_RIGHT_A_DDR	(DDRB)
-#define MOTOR_RIGHT_A_PORT	(PORTB)
-#define MOTOR_RIGHT_B_PIN	(4)
-#define MOTOR_RIGHT_B_DDR	(DDRB)
-#define MOTOR_RIGHT_B_PORT	(PORTB)
+// reversal dead time: a motor which was driven in one direction is only driven in the opposite direction
+// after it was not driven for at least the dead time. The dead time is split into whole periods (q) and
+// the remaining ticks (r), the off time at the end of the last driven period is credited against r, an on time
+// wrapping around the end of the period takes the start of the next period.
+static uint16_t m_reversal_dead_time_us = 0;
+static uint8_t m_dead_time_periods = 0; // q
+static uint16_t m_dead_time_ticks = 0; // r
+
+// triple buffered schedule: the interrupt runs the active one, updates are written to the other ones and latched at
+// the start of the next period, so every update takes effect with exactly the next period. An on time which wraps
+// around the end of a period (right motor interleaved) still belongs to the schedule of the period it started in:
+// the first period after an update then runs a transition schedule with the wrapped on time of the previous schedule,
+// the schedule of the update itself is queued behind it and latched with the following period
+#define PWM_NUM_BUFFERS		(3)
+static s_pwm_schedule m_pwm_schedule[PWM_NUM_BUFFERS] = {{.num_edges = 1}, {.num_edges = 1}, {.num_edges = 1}};
+static volatile uint8_t m_pwm_active = 0;
+static volatile uint8_t m_pwm_next = 0; // latched at the start of the next period if m_pwm_pending
+static volatile bool m_pwm_pending = false;
+static volatile uint8_t m_pwm_queued = 0; // latched one period after m_pwm_next if m_pwm_queued_pending
+static volatile bool m_pwm_queued_pending = false;
+static volatile uint8_t m_pwm_edge_idx = 0;
+static volatile uint16_t m_pwm_period_start = 0; // timer value at the start of the running period
+
+// first order sigma-delta modulator: the fractional part of every edge is added up each period, an overflow
+// delays the edge by one tick in that period. Bit 0 of m_pwm_dither_delay belongs to the next edge of the running period
+static uint8_t m_pwm_dither_acc[PWM_MAX_EDGES] = {0};
+static volatile uint8_t m_pwm_dither_delay = 0;
+
+// reversal state of the channels, only accessed with interrupts disabled
+static uint8_t m_pwm_driven_dir[NUM_OUTPUT_CHANNELS] = {0}; // direction + 1 in which the channel was driven last, 0 if never
+static uint8_t m_pwm_dead_remaining[NUM_OUTPUT_CHANNELS] = {0}; // undriven periods still needed before a reversal
+static uint8_t m_pwm_period_drive[NUM_OUTPUT_CHANNELS] = {0}; // direction + 1 in which the channel is driven in the running period
+static uint8_t m_pwm_period_dead[NUM_OUTPUT_CHANNELS] = {0}; // dead periods needed after the running period
+// the pins of a channel held back for a reversal are cleared with these masks, only accessed with interrupts disabled
+static uint8_t m_pwm_enable[NUM_OUTPUT_PORTS] = {0};
+
+/**
+ * @brief precomputes the edges of one pwm period out of the speed and direction of all channels, the schedule is latched at the start of the next period
+ * @param cut true if the schedule is latched at once (latch_pwm_schedule_now), no on time of the running period carries over then
+ */
+static void update_pwm_schedule(bool const cut);
+
+/**
+ * @brief makes a pending schedule active immediately and restarts it with the next period, needs to be called with interrupts disabled
+ */
+static void latch_pwm_schedule_now();
+
+/**
+ * @brief splits the reversal dead time into whole periods and remaining ticks of the current pwm frequency
+ */
+static void update_dead_time();
+
+/**
+ * @brief makes the pins of the first num_channels channels outputs and the pins of the others inputs without pull-up,
+ * needs to be called with interrupts disabled
+ */
+static void set_output_channels(uint8_t const num_channels);
 
 /**
 * @brief initializes the motor control object
+* @param f pwm frequency to start with
+* @param phase phase relation of both motors to start with
+* @param dithering true for dithering the duty cycle, falls back to 1 kHz in phase without dithering if the three are not a valid setting
+* @param aux true for driving the aux output
 */
-void init_motor_control() {
-	// set value of als Pins to '0'
-	MOTOR_LEFT_A_PORT  &= ~(1<<MOTOR_LEFT_A_PIN);
-	MOTOR_LEFT_B_PORT  &= ~(1<<MOTOR_LEFT_B_PIN);
-	MOTOR_RIGHT_A_PORT &= ~(1<<MOTOR_RIGHT_A_PIN);
-	MOTOR_RIGHT_B_PORT &= ~(1<<MOTOR_RIGHT_B_PIN);
+void init_motor_control(E_PWM_FREQUENCY const f, E_PWM_PHASE const phase, bool const dithering, bool const aux) {
+	for(uint8_t p = 0; p < NUM_OUTPUT_PORTS; p++) m_pwm_enable[p] = 0xFF;
 	
-	// set all pins to output
-	MOTOR_LEFT_A_DDR  |= (1<<MOTOR_LEFT_A_PIN);
-	MOTOR_LEFT_B_DDR  |= (1<<MOTOR_LEFT_B_PIN);
-	MOTOR_RIGHT_A_DDR |= (1<<MOTOR_RIGHT_A_PIN);
-	MOTOR_RIGHT_B_DDR |= (1<<MOTOR_RIGHT_B_PIN);
+	// the output compare b interrupt walks through the edges of the pwm schedule, Timer 1 is started by the timebase
+	TIMSK1 |= (1<<OCIE1B);
 	
-	// enable output compare interrupt a and b and timer 1 overflow interrupt
-	TIMSK0 = (1<<OCIE0A) | (1<<OCIE0B) | (1<<TOIE0);
+	if(!set_pwm_mode(f, phase, dithering, aux)) set_pwm_mode(PWM_1KHZ, PWM_IN_PHASE, false, aux);
+}
+
+/**
+ * @brief changes the pwm frequency, the phase relation and the dithering of all channels and enables or disables the aux output
+ * @param f new pwm frequency
+ * @param phase new phase relation of both motors
+ * @param dithering true for dithering the duty cycle
+ * @param aux true for driving the aux output
+ * @return false if f or phase is not a valid setting or the interrupt load exceeds the cpu budget, nothing is changed then
+ */
+bool set_pwm_mode(E_PWM_FREQUENCY const f, E_PWM_PHASE const phase, bool const dithering, bool const aux) {
+	if(!pwm_mode_valid(f, phase, dithering, aux, 0)) return false;
 	
-	// Timer 0: f = 16 MHz
-	// Prescaler = 64 => tTimerStep = 4 us
-	// fPWM = 1 kHz, Reload Value = 250
-	TCCR0B = (1<<CS01) | (1<<CS00);
+	m_pwm_load = pwm_cpu_load(f, phase, dithering, aux);
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		set_output_channels(aux ? NUM_OUTPUT_CHANNELS : NUM_OUTPUT_CHANNELS - 1);
+		// restart the schedule with the start of a period
+		m_pwm_period_ticks = pgm_read_word(&PWM_SETTING[f].period_ticks);
+		m_pwm_ticks_per_speed = ((uint32_t)(m_pwm_period_ticks) << 16) / MAX_MOTOR_VALUE;
+		m_pwm_on_tick[OUTPUT_RIGHT] = (phase == PWM_INTERLEAVED) ? (m_pwm_period_ticks >> 1) : 0;
+		m_pwm_dithering = dithering;
+		update_dead_time();
+		update_pwm_schedule(true);
+		latch_pwm_schedule_now();
+	}
+	return true;
+}
+
+/**
+ * @brief returns the estimated worst case cpu load of the pwm interrupt in permille for the pwm frequency f with the phase relation phase and dithering,
+ * with or without the aux output
+ */
+uint16_t pwm_cpu_load(E_PWM_FREQUENCY const f, E_PWM_PHASE const phase, bool const dithering, bool const aux) {
+	if((uint8_t)(f) >= PWM_NUM_SETTINGS) return 0;
+	uint32_t const channels = aux ? NUM_OUTPUT_CHANNELS : NUM_OUTPUT_CHANNELS - 1;
+	uint32_t const ports = aux ? NUM_OUTPUT_PORTS : NUM_OUTPUT_PORTS - 1;
+	// every edge of a period costs one interrupt, cycles per period = period_ticks
+	// edges closer than PWM_MIN_EDGE_GAP are waited for within the interrupt, which is never longer than a separate interrupt for that edge would take.
+	// the extra edge of a transition schedule is left out, it comes with one period per update only and the next period runs the steady schedule
+	uint32_t const cycles_per_period = pgm_read_word(&PWM_SETTING[f].period_ticks);
+	uint32_t const edges = (phase == PWM_INTERLEAVED) ? PWM_EDGES_INTERLEAVED(channels) : PWM_EDGES_IN_PHASE(channels);
+	uint32_t cycles = edges * (PWM_ISR_CYCLES + ports * PWM_PORT_CYCLES);
+	cycles += channels * PWM_PERIOD_START_CYCLES;
+	if(dithering) cycles += (edges - 1) * PWM_DITHER_CYCLES;
+	return (uint16_t)(cycles * 1000 / cycles_per_period);
+}
+
+/**
+ * @brief returns true if f and phase are valid settings and the load of the pwm interrupt stays within the cpu budget
+ * together with blocking_load, the share of the cpu in permille during which other interrupts hold the pwm interrupt back.
+ * Edges held back are applied late by the catching up pwm interrupt, so the time they are held back has to fit into the
+ * budget as well (e.g. the dshot decoder)
+ */
+bool pwm_mode_valid(E_PWM_FREQUENCY const f, E_PWM_PHASE const phase, bool const dithering, bool const aux, uint16_t const blocking_load) {
+	if((uint8_t)(f) >= PWM_NUM_SETTINGS || phase > PWM_INTERLEAVED) return false;
+	return (pwm_cpu_load(f, phase, dithering, aux) + blocking_load <= PWM_MAX_CPU_LOAD);
+}
+
+/**
+ * @brief returns the share of the cpu in permille other interrupts may hold the pwm interrupt back in the running pwm mode
+ */
+uint16_t pwm_spare_load() {
+	return PWM_MAX_CPU_LOAD - m_pwm_load;
+}
+
+/**
+ * @brief sets the dead time a motor is not driven before it is driven in the opposite direction
+ * @param us dead time in microseconds, 0 disables the dead time
+ * @return false if us exceeds MAX_REVERSAL_DEAD_TIME_US, the dead time is not changed then
+ */
+bool set_reversal_dead_time(uint16_t const us) {
+	if(us > MAX_REVERSAL_DEAD_TIME_US) return false;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		m_reversal_dead_time_us = us;
+		update_dead_time();
+	}
+	update_pwm_schedule(false);
+	return true;
+}
+
+/**
+ * @brief sets the drive mode of an output channel, the new mode is latched at the start of the next pwm period
+ * @return false if ch is not a channel or mode is not a valid drive mode, the drive mode is not changed then
+ */
+bool set_drive_mode(E_OUTPUT_CHANNEL const ch, E_MOTOR_DRIVE_MODE const mode) {
+	if((uint8_t)(ch) >= NUM_OUTPUT_CHANNELS || mode > DRIVE_BRAKE) return false;
+	m_output[ch].mode = mode;
+	update_pwm_schedule(false);
+	return true;
 }
 
 /**
@@ -76,87 +310,395 @@ void init_motor_control() {
 */
 void enable_motors() {
 	m_motor_state = ENABLED;
+	update_pwm_schedule(false);
 }
 
 /**
-* @brief disables the motor outputs (both Motor + and - are at zero)
+* @brief disables the motor outputs (all output pins are at zero)
 */
 void disable_motors() {
 	m_motor_state = DISABLED;
+	// switching off does not wait for the end of the period
+	update_pwm_schedule(true);
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		latch_pwm_schedule_now();
+	}
 	// disable the motors
-	MOTOR_LEFT_A_PORT  &= ~(1<<MOTOR_LEFT_A_PIN);
-	MOTOR_LEFT_B_PORT  &= ~(1<<MOTOR_LEFT_B_PIN);
-	MOTOR_RIGHT_A_PORT &= ~(1<<MOTOR_RIGHT_A_PIN);
-	MOTOR_RIGHT_B_PORT &= ~(1<<MOTOR_RIGHT_B_PIN);
+	for(uint8_t p = 0; p < NUM_OUTPUT_PORTS; p++) {
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			*OUTPUT_PORT[p].port &= ~m_output_port_mask[p];
+		}
+	}
 }
 
 /**
-* @brief sets the pwm value of the left motor
-* @param dir movement direction of the motor: either forward of backward
-* @param s speed value between 0 and 255 (0 % to 100 %), speed of 0 = BRAKE
+* @brief sets the pwm value of an output channel
+* @param ch output channel
+* @param dir movement direction of the motor: either forward of backward, ignored by single ended outputs
+* @param s speed value between 0 and MAX_MOTOR_VALUE (0 % to 100 %), behaviour at speed 0 depends on the drive mode
 */
-void set_pwm_motor_left(E_MOTOR_DIRECTION const dir, uint8_t const s) {
-	uint16_t speed = s;
-	if(s == 0) {
-		TIMSK0 &= ~(1<<OCIE0A);
+void set_pwm_output(E_OUTPUT_CHANNEL const ch, E_MOTOR_DIRECTION const dir, uint16_t const s) {
+	if((uint8_t)(ch) >= m_num_channels) return;
+	// the control passes the speeds on every tick, the schedule is only computed again if one changed
+	if(m_output[ch].dir == dir && m_output[ch].speed == s) return;
+	m_output[ch].dir = dir;
+	m_output[ch].speed = s;
+	update_pwm_schedule(false);
+}
+
+/**
+ * @brief converts a speed value between 0 and MAX_MOTOR_VALUE into the on time in timer ticks
+ * @param frac returns the fractional part of the on time in 1/256 ticks with dithering, 0 otherwise
+ */
+static uint16_t speed_to_ticks(uint16_t const speed, uint8_t *frac) {
+	uint32_t const scaled = (uint32_t)(speed) * m_pwm_ticks_per_speed;
+	uint16_t ticks = 0;
+	*frac = 0;
+	if(m_pwm_dithering) {
+		ticks = (uint16_t)(scaled >> 16);
+		*frac = (uint8_t)(scaled >> 8);
+	} else {
+		ticks = (uint16_t)((scaled + 0x8000) >> 16);
+	}
+	if(ticks >= m_pwm_period_ticks) {
+		*frac = 0;
+		return m_pwm_period_ticks;
 	}
-	else {
-		OCR0A = 255 - speed;
-		TIMSK0 |= (1<<OCIE0A);
+	// a switch off edge that close to the end of the period would need busy waiting for the start of the next period,
+	// round to the last edge that can be rearmed or to the motor staying on the whole period
+	uint16_t const last_tick = m_pwm_period_ticks - PWM_MIN_EDGE_GAP;
+	if(ticks > last_tick) {
+		*frac = 0;
+		if(ticks - last_tick > (PWM_MIN_EDGE_GAP >> 1)) return m_pwm_period_ticks;
+		else return last_tick;
 	}
-	m_motor_left_dir = dir;
+	return ticks;
 }
 
 /**
-* @brief sets the pwm value of the right motor
-* @param dir movement direction of the motor: either forward of backward
-* @param s speed value between 0 and 255 (0 % to 100 %), speed of 0 = BRAKE
-*/
-void set_pwm_motor_right(E_MOTOR_DIRECTION const dir, uint8_t const s) {
-	uint16_t speed = s;
-	if(s == 0) {
-		TIMSK0 &= ~(1<<OCIE0B);
+ * @brief makes the pins of the first num_channels channels outputs and the pins of the others inputs without pull-up,
+ * needs to be called with interrupts disabled
+ */
+static void set_output_channels(uint8_t const num_channels) {
+	s_output_channel channel[NUM_OUTPUT_CHANNELS];
+	memcpy_P(channel, OUTPUT_CHANNEL, sizeof(channel));
+	for(uint8_t p = 0; p < NUM_OUTPUT_PORTS; p++) m_output_port_mask[p] = 0;
+	m_num_ports = 0;
+	for(uint8_t c = 0; c < NUM_OUTPUT_CHANNELS; c++) {
+		s_output_port const *port = &OUTPUT_PORT[channel[c].port];
+		uint8_t const pins = channel[c].pin_a | channel[c].pin_b;
+		if(c < num_channels) {
+			// the pins of a channel which was already in use keep their state until the next edge
+			if((*port->ddr & pins) != pins) *port->port &= ~pins;
+			*port->ddr |= pins;
+			m_output_port_mask[channel[c].port] |= pins;
+			if((uint8_t)(channel[c].port) >= m_num_ports) m_num_ports = (uint8_t)(channel[c].port) + 1;
+		} else {
+			*port->ddr &= ~pins;
+			*port->port &= ~pins;
+			m_output[c].speed = 0;
+		}
 	}
-	else {
-		OCR0B = 255 - speed;
-		TIMSK0 |= (1<<OCIE0B);
+	m_num_channels = num_channels;
+}
+
+/**
+ * @brief splits the reversal dead time into whole periods and remaining ticks of the current pwm frequency
+ */
+static void update_dead_time() {
+	uint32_t const dead_time_ticks = (uint32_t)(m_reversal_dead_time_us) * (F_CPU / 1000000UL);
+	m_dead_time_periods = (uint8_t)(dead_time_ticks / m_pwm_period_ticks);
+	m_dead_time_ticks = (uint16_t)(dead_time_ticks % m_pwm_period_ticks);
+}
+
+/**
+ * @brief inserts an edge at tick with the fractional part frac into the edges sorted in ascending order unless there already is one at that tick
+ * edges merged with a different fractional part are not dithered, as delaying them would shift the other edge as well
+ * @return the new number of edges
+ */
+static uint8_t insert_pwm_edge(s_pwm_edge *edge, uint8_t num_edges, uint16_t const tick, uint8_t const frac) {
+	uint8_t i = 0;
+	while(i < num_edges && edge[i].tick < tick) i++;
+	if(i < num_edges && edge[i].tick == tick) {
+		if(edge[i].frac != frac) edge[i].frac = 0;
+		return num_edges;
+	}
+	for(uint8_t k = num_edges; k > i; k--) {
+		edge[k].tick = edge[k-1].tick;
+		edge[k].frac = edge[k-1].frac;
 	}
-	m_motor_right_dir = dir;
+	edge[i].tick = tick;
+	edge[i].frac = frac;
+	return num_edges + 1;
 }
 
 /**
-* @brief ISR for Timer 0 overflow vector
-*/
-ISR(TIMER0_OVF_vect) {
-	// switch the motors off
-	MOTOR_LEFT_A_PORT  &= ~(1<<MOTOR_LEFT_A_PIN);
-	MOTOR_LEFT_B_PORT  &= ~(1<<MOTOR_LEFT_B_PIN);
-	MOTOR_RIGHT_A_PORT &= ~(1<<MOTOR_RIGHT_A_PIN);
-	MOTOR_RIGHT_B_PORT &= ~(1<<MOTOR_RIGHT_B_PIN);
+ * @brief returns the periods a channel has to stay undriven after a period in which it was driven till on_end (ticks
+ * after the start of the period, beyond the period for an on time which wraps around its end) before it may be driven
+ * in the opposite direction: the real off time after n undriven periods is n * period - (on_end - period)
+ */
+static uint8_t pwm_dead_periods(uint16_t const on_end) {
+	if(m_dead_time_periods == 0 && m_dead_time_ticks == 0) return 0;
+	int32_t const excess = (int32_t)(m_dead_time_ticks) + on_end - m_pwm_period_ticks;
+	if(excess <= 0) return m_dead_time_periods;
+	if(excess <= (int32_t)(m_pwm_period_ticks)) return m_dead_time_periods + 1;
+	return m_dead_time_periods + 2;
 }
 
 /**
-* @brief ISR for output compare channel A (left motor)
-*/
-ISR(TIMER0_COMPA_vect) {
-	if(m_motor_state == ENABLED) {
-		if(m_motor_left_dir == FWD) {
-			MOTOR_LEFT_A_PORT  |= (1<<MOTOR_LEFT_A_PIN);
-		} else if(m_motor_left_dir == BWD) {
-			MOTOR_LEFT_B_PORT  |= (1<<MOTOR_LEFT_B_PIN);
+ * @brief returns the state of the output pins of channel ch while it is driven in direction drive - 1
+ */
+static inline uint8_t pwm_on_pins(s_output_channel const *ch, uint8_t const drive) {
+	return (drive == (uint8_t)(BWD) + 1) ? ch->pin_b : ch->pin_a;
+}
+
+/**
+ * @brief computes the edges of one period out of the on times of the channels starting in this period (window) and
+ * the on times of the previous period which wrap around its end (tail), the latter run from tick 0 till the on tick.
+ * off_pins is the state of the output pins of each channel during the off time
+ */
+static void build_pwm_schedule(s_pwm_schedule *schedule, s_pwm_window const *window, s_pwm_window const *tail, uint8_t const *off_pins, s_output_channel const *channel) {
+	s_pwm_edge *edge = schedule->edge;
+	
+	// start of the period at tick 0, followed by the switch on and off edges in ascending order,
+	// edges at the same tick are merged into one. Only the switch off edges are dithered, the period start never
+	edge[0].tick = 0;
+	edge[0].frac = 0;
+	uint8_t num_edges = 1;
+	for(uint8_t c = 0; c < NUM_OUTPUT_CHANNELS; c++) {
+		uint16_t const on_tick = m_pwm_on_tick[c];
+		s_pwm_window const *w = &window[c];
+		s_pwm_window const *t = &tail[c];
+		if(on_tick == 0) {
+			if(w->ticks == 0 || w->ticks == m_pwm_period_ticks) continue; // channel is off or on for the whole period
+			num_edges = insert_pwm_edge(edge, num_edges, w->ticks, w->frac);
+			continue;
+		}
+		// the pins change at the on tick unless the tail lasts till there and the channel stays on or both are off
+		uint8_t const before = (t->ticks >= m_pwm_period_ticks) ? pwm_on_pins(&channel[c], t->drive) : off_pins[c];
+		uint8_t const after = (w->ticks > 0) ? pwm_on_pins(&channel[c], w->drive) : off_pins[c];
+		if(before != after) num_edges = insert_pwm_edge(edge, num_edges, on_tick, 0);
+		// an on time wrapping around the end of the period is switched off by the schedule of the next period
+		if(w->ticks > 0 && on_tick + w->ticks < m_pwm_period_ticks) num_edges = insert_pwm_edge(edge, num_edges, on_tick + w->ticks, w->frac);
+		if(t->ticks > m_pwm_period_ticks - on_tick && t->ticks < m_pwm_period_ticks) num_edges = insert_pwm_edge(edge, num_edges, on_tick + t->ticks - m_pwm_period_ticks, t->frac);
+	}
+	// a channel is driven from its on tick for ticks ticks, before its on tick the tail of the previous period runs
+	for(uint8_t k = 0; k < num_edges; k++) {
+		for(uint8_t p = 0; p < NUM_OUTPUT_PORTS; p++) edge[k].port[p] = 0;
+		for(uint8_t c = 0; c < NUM_OUTPUT_CHANNELS; c++) {
+			s_pwm_window const *w = &window[c];
+			uint16_t since_on = edge[k].tick - m_pwm_on_tick[c];
+			if(edge[k].tick < m_pwm_on_tick[c]) {
+				w = &tail[c];
+				since_on += m_pwm_period_ticks;
+			}
+			edge[k].port[channel[c].port] |= (w->ticks > since_on) ? pwm_on_pins(&channel[c], w->drive) : off_pins[c];
 		}
 	}
+	
+	schedule->num_edges = num_edges;
+	for(uint8_t c = 0; c < NUM_OUTPUT_CHANNELS; c++) {
+		schedule->window[c] = window[c];
+		schedule->tail_drive[c] = (tail[c].ticks > m_pwm_period_ticks - m_pwm_on_tick[c]) ? tail[c].drive : 0;
+	}
 }
 
 /**
-* @brief ISR for output compare channel B (right motor)
+ * @brief precomputes the edges of one pwm period out of the speed and direction of all channels
+ * @param cut true if the schedule is latched at once (latch_pwm_schedule_now), no on time of the running period carries over then
+ */
+static void update_pwm_schedule(bool const cut) {
+	s_pwm_window window[NUM_OUTPUT_CHANNELS];
+	uint8_t off_pins[NUM_OUTPUT_CHANNELS] = {0};
+	s_output_channel channel[NUM_OUTPUT_CHANNELS];
+	memcpy_P(channel, OUTPUT_CHANNEL, sizeof(channel));
+	
+	for(uint8_t c = 0; c < NUM_OUTPUT_CHANNELS; c++) {
+		s_pwm_window *w = &window[c];
+		w->ticks = 0;
+		w->frac = 0;
+		w->drive = 0;
+		w->dead_periods = 0;
+		if(m_motor_state != ENABLED || c >= m_num_channels) continue;
+		s_output_channel const *ch = &channel[c];
+		w->ticks = speed_to_ticks(m_output[c].speed, &w->frac);
+		// both bridge inputs high shorts the motor, DRIVE_BRAKE only while the motor is driven
+		if(ch->pin_b != 0 && (m_output[c].mode == BRAKE || (m_output[c].mode == DRIVE_BRAKE && m_output[c].speed != 0))) {
+			off_pins[c] = ch->pin_a | ch->pin_b;
+		}
+		// reversal bookkeeping: the off time till the end of a driven period already counts towards the dead time,
+		// so a reversal is only delayed by the periods still missing. Single ended outputs have only one direction
+		if(w->ticks > 0) {
+			w->drive = (ch->pin_b == 0) ? (uint8_t)(FWD) + 1 : (uint8_t)(m_output[c].dir) + 1;
+			w->dead_periods = pwm_dead_periods(m_pwm_on_tick[c] + w->ticks);
+		}
+	}
+	
+	// withdrawing the pending schedules first keeps the interrupt from switching to a buffer while it is written,
+	// the active schedule is not changed by the interrupt then and its on times are the tail of the next period
+	uint8_t active = 0;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		m_pwm_pending = false;
+		m_pwm_queued_pending = false;
+		active = m_pwm_active;
+	}
+	s_pwm_window tail[NUM_OUTPUT_CHANNELS];
+	bool transition = false;
+	for(uint8_t c = 0; c < NUM_OUTPUT_CHANNELS; c++) {
+		tail[c] = m_pwm_schedule[active].window[c];
+		if(cut) {
+			tail[c].ticks = 0;
+			tail[c].drive = 0;
+		}
+		s_pwm_window const *t = &tail[c], *w = &window[c];
+		// only the state before the on tick differs, which is tick 0 for the channels without interleaving
+		if(m_pwm_on_tick[c] != 0 && (t->ticks != w->ticks || t->frac != w->frac || t->drive != w->drive)) transition = true;
+	}
+	
+	// the schedules are built in the free buffers with interrupts enabled
+	uint8_t const first = (active + 1 < PWM_NUM_BUFFERS) ? (active + 1) : 0;
+	uint8_t const second = (first + 1 < PWM_NUM_BUFFERS) ? (first + 1) : 0;
+	build_pwm_schedule(&m_pwm_schedule[first], window, transition ? tail : window, off_pins, channel);
+	if(transition) build_pwm_schedule(&m_pwm_schedule[second], window, window, off_pins, channel);
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		m_pwm_next = first;
+		m_pwm_pending = true;
+		m_pwm_queued = second;
+		m_pwm_queued_pending = transition;
+	}
+}
+
+/**
+ * @brief reversal state machine, called with interrupts disabled before the start of every period with the schedule of that period:
+ * a channel which is to be driven in the opposite direction than it was driven last is held back (both pins low)
+ * until it was not driven for the dead time
+ */
+static inline void pwm_period_start(s_pwm_schedule const *schedule) {
+	for(uint8_t p = 0; p < NUM_OUTPUT_PORTS; p++) m_pwm_enable[p] = 0xFF;
+	for(uint8_t c = 0; c < m_num_channels; c++) {
+		// account the period which just ended
+		uint8_t const last = m_pwm_period_drive[c];
+		if(last) {
+			m_pwm_driven_dir[c] = last;
+			m_pwm_dead_remaining[c] = m_pwm_period_dead[c];
+		} else if(m_pwm_dead_remaining[c] > 0) {
+			m_pwm_dead_remaining[c]--;
+		}
+		// check the period which starts now, an on time wrapping into it is held back as well if it was held back
+		// in the period it started in, its dead time is already part of the dead periods of that period
+		uint8_t drive = schedule->window[c].drive;
+		uint8_t const tail = schedule->tail_drive[c];
+		if((drive && drive != m_pwm_driven_dir[c] && m_pwm_dead_remaining[c] > 0) || (tail && tail != last)) {
+			s_output_channel const *ch = &OUTPUT_CHANNEL[c];
+			m_pwm_enable[pgm_read_byte(&ch->port)] &= ~(pgm_read_byte(&ch->pin_a) | pgm_read_byte(&ch->pin_b));
+			drive = 0;
+		}
+		m_pwm_period_drive[c] = drive;
+		m_pwm_period_dead[c] = schedule->window[c].dead_periods;
+	}
+}
+
+/**
+ * @brief sigma-delta step of the dithering, called with interrupts disabled before the start of every period with the schedule of that period
+ * @return the edges delayed by one tick in this period, bit k - 1 for edge k
+ */
+static inline uint8_t pwm_dither(s_pwm_schedule const *schedule) {
+	uint8_t delay = 0;
+	for(uint8_t k = schedule->num_edges - 1; k > 0; k--) {
+		uint8_t const acc = m_pwm_dither_acc[k] + schedule->edge[k].frac;
+		delay <<= 1;
+		if(acc < m_pwm_dither_acc[k]) delay |= 1;
+		m_pwm_dither_acc[k] = acc;
+	}
+	return delay;
+}
+
+/**
+ * @brief prepares the period which starts with the next edge: latches a pending schedule and runs the reversal bookkeeping
+ * and the dithering, called with interrupts disabled after the last edge of the running period was applied
+ * @return the edges delayed by one tick in the next period, bit k for edge k
+ */
+static inline uint8_t pwm_next_period() {
+	if(m_pwm_pending) {
+		m_pwm_active = m_pwm_next;
+		// the schedule of an update follows its transition schedule with the next period
+		m_pwm_next = m_pwm_queued;
+		m_pwm_pending = m_pwm_queued_pending;
+		m_pwm_queued_pending = false;
+	}
+	s_pwm_schedule const *schedule = &m_pwm_schedule[m_pwm_active];
+	pwm_period_start(schedule);
+	// the period start is never delayed
+	return m_pwm_dithering ? (uint8_t)(pwm_dither(schedule) << 1) : 0;
+}
+
+/**
+ * @brief makes a pending schedule active immediately and restarts it with the next period, needs to be called with interrupts disabled
+ */
+static void latch_pwm_schedule_now() {
+	// the running period is cut short, so its off time can not be credited against the dead time
+	for(uint8_t c = 0; c < NUM_OUTPUT_CHANNELS; c++) {
+		if(m_pwm_period_drive[c]) m_pwm_period_dead[c] = m_dead_time_periods + ((m_dead_time_ticks > 0) ? 1 : 0);
+	}
+	m_pwm_edge_idx = 0;
+	m_pwm_dither_delay = pwm_next_period();
+	m_pwm_period_start = TCNT1 + PWM_MIN_EDGE_GAP;
+	OCR1B = m_pwm_period_start;
+	TIFR1 = (1<<OCF1B); // discard a compare match of the old schedule
+}
+
+/**
+* @brief ISR for output compare channel B of Timer 1, applies the precomputed edges of the pwm schedule
+* 
+* This is the only interrupt of the pwm engine, it fires once per distinct edge in a period:
+*   all channels stopped or at full speed              -> 1 interrupt / period (period start)
+*   every channel with pwm and a different speed       -> 1 + channels in use interrupts / period
+*   interleaved                                        -> up to 2 + channels in use interrupts / period, one more in the
+*                                                         first period after an update if the previous on time of the right motor wraps into it
+* Timer 1 runs free, so every edge is scheduled relative to the start of its period and the compare unit is
+* rearmed for the next edge. If the next edge is closer than PWM_MIN_EDGE_GAP or was already missed because the
+* interrupt was delayed, it is applied within this run (catching up), a compare value in the past would only match
+* again after the timer wrapped around (4.1 ms). The time per interrupt is constant here, estimated PWM_ISR_CYCLES
+* including prologue/epilogue plus PWM_PORT_CYCLES per output port (4 us with two ports) plus up to PWM_MIN_EDGE_GAP
+* ticks busy waiting when two edges are closer than that, the interrupt of the last edge of a period additionally
+* latches the schedule of the next period and runs its reversal bookkeeping (PWM_PERIOD_START_CYCLES per channel) and,
+* if enabled, its dithering (PWM_DITHER_CYCLES per edge after the period start) after its own edge was written, so the
+* switch on edges at the period start are the first thing the next interrupt does. The delay of a dithered edge costs 3 more cycles in every run (shift of the delay bits
+* and conditional increment). So the work per period grows linearly with the number of channels.
+* Estimated worst case load with the two motors (see pwm_cpu_load): 1 kHz 1.4 %, 4 kHz 5.6 %, 8 kHz 11.3 %, 16 kHz 22.5 %,
+* 20 kHz 28.1 %, interleaved 1 kHz 1.8 %, 4 kHz 7.3 %, 8 kHz 14.5 %, 16 kHz 29.0 %, 20 kHz 36.3 % (exceeds PWM_MAX_CPU_LOAD,
+* rejected), dithering adds 0.2 - 0.3 % at 1 kHz up to 4.0 - 6.0 % at 20 kHz, so it is rejected at 20 kHz and at 16 kHz interleaved.
+* With the aux output (three channels on three ports): 1 kHz 2.2 %, 4 kHz 9.1 %, 8 kHz 18.2 %, interleaved 1 kHz 2.7 %,
+* 4 kHz 11.1 %, 8 kHz 22.2 %, 16 kHz and 20 kHz are rejected
 */
-ISR(TIMER0_COMPB_vect) {
-	if(m_motor_state == ENABLED) {
-		if(m_motor_right_dir == FWD) {
-			MOTOR_RIGHT_A_PORT  |= (1<<MOTOR_RIGHT_A_PIN);
-		} else if(m_motor_right_dir == BWD) {
-			MOTOR_RIGHT_B_PORT  |= (1<<MOTOR_RIGHT_B_PIN);
+ISR(TIMER1_COMPB_vect) {
+	uint8_t idx = m_pwm_edge_idx;
+	uint16_t start = m_pwm_period_start;
+	s_pwm_schedule const *schedule = &m_pwm_schedule[m_pwm_active];
+	uint8_t delay = m_pwm_dither_delay;
+	uint16_t next = 0;
+	for(;;) {
+		for(uint8_t p = 0; p < m_num_ports; p++) {
+			volatile uint8_t *port = OUTPUT_PORT[p].port;
+			*port = (*port & ~m_output_port_mask[p]) | (schedule->edge[idx].port[p] & m_pwm_enable[p]);
+		}
+		delay >>= 1;
+		idx++;
+		if(idx >= schedule->num_edges) {
+			// the next edge is the start of the next period, its schedule is prepared now
+			idx = 0;
+			start += m_pwm_period_ticks;
+			delay = pwm_next_period();
+			schedule = &m_pwm_schedule[m_pwm_active];
 		}
+		next = start + schedule->edge[idx].tick;
+		if(delay & 1) next++; // bit 0 is never set for the period start
+		if((int16_t)(next - TCNT1) > PWM_MIN_EDGE_GAP) break;
+		// the next edge is too close for rearming the compare unit, wait for it here
+		while((int16_t)(TCNT1 - next) < 0) { }
 	}
+	OCR1B = next;
+	m_pwm_edge_idx = idx;
+	m_pwm_dither_delay = delay;
+	m_pwm_period_start = start;
 }
@@ -27,16 +27,89 @@
 #define MOTOR_CONTROL_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 typedef enum {ENABLED = 0, DISABLED = 1} E_MOTOR_STATE;
 typedef enum {FWD = 0, BWD = 1} E_MOTOR_DIRECTION;
+/* drive mode of a motor, determines the state of the h-bridge during the pwm off time and at zero speed:
+ * COAST       - both bridge inputs low during the off time and at zero speed
+ * BRAKE       - both bridge inputs high during the off time and at zero speed, the motor is shorted (slow decay)
+ * DRIVE_BRAKE - both bridge inputs high during the off time (slow decay while driven), both low at zero speed
+ * The Si9986 drivers on the esc have no enable input, every output follows its input: low switches the low side of
+ * the half bridge on, high the high side. So the bridge can not release the motor, both inputs low shorts it via
+ * the low sides as well and all three modes brake on this board, they only differ in the pair of switches which
+ * shorts the motor. The modes only coast on drivers where both inputs low disables the bridge (IN/IN type),
+ * both inputs high brakes on both kinds of drivers */
+typedef enum {COAST = 0, BRAKE = 1, DRIVE_BRAKE = 2} E_MOTOR_DRIVE_MODE;
+typedef enum {PWM_1KHZ = 0, PWM_4KHZ = 1, PWM_8KHZ = 2, PWM_16KHZ = 3, PWM_20KHZ = 4} E_PWM_FREQUENCY;
+/* phase relation of the pwm of both motors:
+ * PWM_IN_PHASE    - both motors are switched on at the start of the period
+ * PWM_INTERLEAVED - the on time of the right motor starts half a period later, so the current pulses of both motors
+ *                   do not overlap as long as each duty cycle is at most 50 % and the supply current is smoothed */
+typedef enum {PWM_IN_PHASE = 0, PWM_INTERLEAVED = 1} E_PWM_PHASE;
+/* pwm dithering: the on time of a motor is only a whole number of timer ticks, with dithering the fractional part is
+ * spread over successive periods by a first order sigma-delta modulator, so the mean duty cycle follows the speed
+ * with the full MAX_MOTOR_VALUE resolution at every pwm frequency. Without dithering the on time is rounded to the nearest tick */
 	
-static volatile uint16_t const MAX_MOTOR_VALUE = 8160; // //255 << 5;
+// output channels, the pin mapping of each channel is in the channel table of motor_control.c. The aux output is a
+// single ended output on PD7 of the spare connector (e.g. for the speed controller of a weapon motor), it ignores the
+// direction and the drive mode. It is only driven if it is enabled with the pwm mode and costs one pwm edge and one
+// output port more per period then, see pwm_cpu_load
+typedef enum {OUTPUT_LEFT = 0, OUTPUT_RIGHT = 1, OUTPUT_AUX = 2} E_OUTPUT_CHANNEL;
+#define NUM_OUTPUT_CHANNELS	(3)
+
+static volatile uint16_t const MAX_MOTOR_VALUE = 8160; // //255 << 5, full speed, the speed is carried with this resolution down to the pwm
+
+#define MAX_REVERSAL_DEAD_TIME_US	(5000)
 
 /** 
  * @brief initializes the motor control object
+ * @param f pwm frequency to start with
+ * @param phase phase relation of both motors to start with
+ * @param dithering true for dithering the duty cycle, falls back to 1 kHz in phase without dithering if the three are not a valid setting
+ * @param aux true for driving the aux output
+ */
+void init_motor_control(E_PWM_FREQUENCY const f, E_PWM_PHASE const phase, bool const dithering, bool const aux);
+
+/**
+ * @brief changes the pwm frequency, the phase relation and the dithering of all channels and enables or disables the aux output
+ * @param f new pwm frequency
+ * @param phase new phase relation of both motors
+ * @param dithering true for dithering the duty cycle
+ * @param aux true for driving the aux output, its pin is an input without pull-up otherwise
+ * @return false if f or phase is not a valid setting or the interrupt load exceeds the cpu budget, nothing is changed then
+ */
+bool set_pwm_mode(E_PWM_FREQUENCY const f, E_PWM_PHASE const phase, bool const dithering, bool const aux);
+
+/**
+ * @brief returns the estimated worst case cpu load of the pwm interrupt in permille for the pwm frequency f with the phase relation phase and dithering,
+ * with or without the aux output
+ */
+uint16_t pwm_cpu_load(E_PWM_FREQUENCY const f, E_PWM_PHASE const phase, bool const dithering, bool const aux);
+
+/**
+ * @brief returns true if f and phase are valid settings and the load of the pwm interrupt stays within the cpu budget
+ * together with blocking_load, the share of the cpu in permille during which other interrupts hold the pwm interrupt back
  */
-void init_motor_control();
+bool pwm_mode_valid(E_PWM_FREQUENCY const f, E_PWM_PHASE const phase, bool const dithering, bool const aux, uint16_t const blocking_load);
+
+/**
+ * @brief returns the share of the cpu in permille other interrupts may hold the pwm interrupt back in the running pwm mode
+ */
+uint16_t pwm_spare_load();
+
+/**
+ * @brief sets the dead time a motor is not driven before it is driven in the opposite direction
+ * @param us dead time in microseconds, 0 disables the dead time
+ * @return false if us exceeds MAX_REVERSAL_DEAD_TIME_US, the dead time is not changed then
+ */
+bool set_reversal_dead_time(uint16_t const us);
+
+/**
+ * @brief sets the drive mode of an output channel, the new mode is latched at the start of the next pwm period
+ * @return false if ch is not a channel or mode is not a valid drive mode, the drive mode is not changed then
+ */
+bool set_drive_mode(E_OUTPUT_CHANNEL const ch, E_MOTOR_DRIVE_MODE const mode);
 
 /** 
  * @brief enables the motor outputs
@@ -44,22 +117,17 @@ void init_motor_control();
 void enable_motors();
 
 /** 
- * @brief disables the motor outputs (both Motor + and - are at zero)
+ * @brief disables the motor outputs (all output pins are at zero)
  */	
 void disable_motors();
 
 /**
- * @brief sets the pwm value of the left motor
- * @param dir movement direction of the motor: either forward of backward
- * @param s speed value between 0 and 255 << 5 (0 % to 100 %), speed of 0 = BRAKE
- */
-void set_pwm_motor_left(E_MOTOR_DIRECTION const dir, uint8_t const s);
-	
-/**
- * @brief sets the pwm value of the right motor
- * @param dir movement direction of the motor: either forward of backward
- * @param s speed value between 0 and 255 << 5 (0 % to 100 %), speed of 0 = BRAKE
+ * @brief sets the pwm value of an output channel
+ * @param ch output channel
+ * @param dir movement direction of the motor: either forward of backward, ignored by single ended outputs
+ * @param s speed value between 0 and MAX_MOTOR_VALUE (0 % to 100 %), behaviour at speed 0 depends on the drive mode
+ * the new value is latched at the start of the next pwm period, the aux output stays off while it is disabled
  */
-void set_pwm_motor_right(E_MOTOR_DIRECTION const dir, uint8_t const s);
+void set_pwm_output(E_OUTPUT_CHANNEL const ch, E_MOTOR_DIRECTION const dir, uint16_t const s);
 
 #endif /* MOTOR_CONTROL_H_ */
@@ -0,0 +1,87 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @author Alexander Entinger, BSc
+* @brief this module decodes the sbus frames of a receiver
+* @file sbus.c
+*/
+
+#include "sbus.h"
+
+#include <avr/io.h>
+
+/*
+ * frame (25 bytes, 3 ms at 100000 baud, every 7 or 14 ms):
+ *   0x0F | 22 bytes = 16 channels with 11 bit, lsb first | flags | 0x00 (sbus) or 0x04/0x14/0x24/0x34 (sbus2 slots)
+ * sbus has no checksum, a frame is synchronised to the gap between two frames and checked by its header and footer.
+ * The frame is collected in the shared frame buffer and unpacked by get_channels right after it was completed.
+ */
+#define SBUS_FRAME_SIZE		(25)
+#define SBUS_HEADER			(0x0F)
+#define SBUS_FLAGS_IDX		(23)
+#define SBUS_FLAG_FRAME_LOST	(1<<2)
+#define SBUS_FLAG_FAILSAFE		(1<<3)
+
+static uint8_t m_idx = SBUS_FRAME_SIZE; // index of the next byte within the frame, SBUS_FRAME_SIZE = wait for the gap
+
+/**
+ * @brief discards a partially received frame, the next frame starts after a gap
+ */
+static void sbus_reset() {
+	m_idx = SBUS_FRAME_SIZE;
+}
+
+/**
+ * @brief processes one received byte
+ */
+static E_SERIAL_FRAME sbus_parse(uint8_t const data, bool const gap) {
+	if(gap) m_idx = 0;
+	if(m_idx >= SBUS_FRAME_SIZE) return SERIAL_FRAME_INCOMPLETE;
+	if(m_idx == 0 && data != SBUS_HEADER) {
+		m_idx = SBUS_FRAME_SIZE;
+		return SERIAL_FRAME_ERROR;
+	}
+	serial_frame_buffer[m_idx++] = data;
+	if(m_idx < SBUS_FRAME_SIZE) return SERIAL_FRAME_INCOMPLETE;
+	// footer of sbus or of one of the sbus2 slots
+	if((data & 0x0F) != 0x00 && (data & 0x0F) != 0x04) return SERIAL_FRAME_ERROR;
+	return SERIAL_FRAME_CHANNELS;
+}
+
+/**
+ * @brief unpacks the channels of the frame just completed in units of 4 us
+ */
+static uint8_t sbus_get_channels(uint16_t *channels) {
+	serial_unpack_11bit(&serial_frame_buffer[1], SBUS_NUM_CHANNELS, channels);
+	uint8_t flags = 0;
+	if(serial_frame_buffer[SBUS_FLAGS_IDX] & SBUS_FLAG_FRAME_LOST) flags |= SERIAL_FLAG_FRAME_LOST;
+	if(serial_frame_buffer[SBUS_FLAGS_IDX] & SBUS_FLAG_FAILSAFE) flags |= SERIAL_FLAG_FAILSAFE;
+	return flags;
+}
+
+serial_decoder const SBUS_DECODER PROGMEM = {
+	.baudrate = 100000,
+	.double_speed = false,
+	.frame_format = (1<<UPM11) | (1<<USBS1) | (1<<UCSZ11) | (1<<UCSZ10), // 8 data bits, even parity, 2 stop bits
+	.num_channels = SBUS_NUM_CHANNELS,
+	.reset = sbus_reset,
+	.parse = sbus_parse,
+	.get_channels = sbus_get_channels
+};
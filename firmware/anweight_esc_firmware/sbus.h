@@ -0,0 +1,38 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @author Alexander Entinger, BSc
+* @brief this module decodes the sbus frames of a receiver
+* @file sbus.h
+*/
+
+#ifndef SBUS_H_
+#define SBUS_H_
+
+#include "serial_decoder.h"
+
+#define SBUS_NUM_CHANNELS		(16)
+
+/**
+ * @brief sbus: 100000 baud, 8E2, the signal must be inverted in hardware since the usart can not invert it
+ */
+extern serial_decoder const SBUS_DECODER PROGMEM;
+
+#endif /* SBUS_H_ */
@@ -0,0 +1,45 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @author Alexander Entinger, BSc
+* @brief this file contains the parts shared by the frame decoders of the serial receiver protocols
+* @file serial_decoder.c
+*/
+
+#include "serial_decoder.h"
+
+uint8_t serial_frame_buffer[SERIAL_MAX_FRAME_SIZE];
+
+/**
+ * @brief unpacks num_channels channels with 11 bit, lsb first (sbus, crsf) from data in units of 4 us into channels
+ */
+void serial_unpack_11bit(uint8_t const *data, uint8_t const num_channels, uint16_t *channels) {
+	uint32_t bits = 0;
+	uint8_t num_bits = 0, ch = 0;
+	while(ch < num_channels) {
+		bits |= (uint32_t)(*data++) << num_bits;
+		num_bits += 8;
+		if(num_bits >= 11) {
+			channels[ch++] = SERIAL_11BIT_TO_4US((uint16_t)(bits) & 0x07FF);
+			bits >>= 11;
+			num_bits -= 11;
+		}
+	}
+}
@@ -0,0 +1,83 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @author Alexander Entinger, BSc
+* @brief this file defines the interface of the frame decoders of the serial receiver protocols
+* @file serial_decoder.h
+*/
+
+#ifndef SERIAL_DECODER_H_
+#define SERIAL_DECODER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+
+typedef enum {SERIAL_FRAME_INCOMPLETE = 0, SERIAL_FRAME_CHANNELS = 1, SERIAL_FRAME_OTHER = 2, SERIAL_FRAME_ERROR = 3} E_SERIAL_FRAME;
+
+// flags returned by get_channels
+#define SERIAL_FLAG_FRAME_LOST	(1<<0) // the receiver missed the last frame of the transmitter, the channels are repeated
+#define SERIAL_FLAG_FAILSAFE	(1<<1) // the receiver lost the transmitter and entered failsafe
+
+// 11 bit channel value of sbus and crsf to 4 us units: t = 1500 us + (value - 992) * 5 / 8 = 880 us + value * 5 / 8
+#define SERIAL_11BIT_TO_4US(value)	((uint16_t)(((value) * 5) >> 5) + 220)
+
+// longest frame of the supported protocols (crsf)
+#define SERIAL_MAX_FRAME_SIZE	(64)
+
+/**
+ * the frame buffer of the decoders, only the decoder of the active input mode uses it, so they share one buffer
+ */
+extern uint8_t serial_frame_buffer[SERIAL_MAX_FRAME_SIZE];
+
+/**
+ * @brief a frame decoder, parse is fed with the received bytes one by one from the main loop.
+ * The decoders are kept in flash (PROGMEM) and copied with memcpy_P before use
+ */
+typedef struct serial_decoder {
+	uint32_t baudrate;
+	bool double_speed; // usart double speed mode for a lower baudrate error
+	uint8_t frame_format; // UCSR1C: data bits, parity and stop bits
+	uint8_t num_channels;
+	/**
+	 * @brief discards a partially received frame
+	 */
+	void (*reset)();
+	/**
+	 * @brief processes one received byte
+	 * @param gap true if the line was idle for more than 1 ms before the byte
+	 * @return SERIAL_FRAME_CHANNELS if the byte completed a valid frame with channel data, SERIAL_FRAME_OTHER for any
+	 * other valid frame, SERIAL_FRAME_ERROR if the checksum or the framing of the frame is wrong
+	 */
+	E_SERIAL_FRAME (*parse)(uint8_t const data, bool const gap);
+	/**
+	 * @brief decodes the channels of the frame just completed by parse in units of 4 us into channels (num_channels
+	 * values), the frame is only kept in serial_frame_buffer until the next byte is parsed
+	 * @return SERIAL_FLAG_xxx of the frame
+	 */
+	uint8_t (*get_channels)(uint16_t *channels);
+} serial_decoder;
+
+/**
+ * @brief unpacks num_channels channels with 11 bit, lsb first (sbus, crsf) from data in units of 4 us into channels
+ */
+void serial_unpack_11bit(uint8_t const *data, uint8_t const num_channels, uint16_t *channels);
+
+#endif /* SERIAL_DECODER_H_ */
@@ -0,0 +1,124 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @author Alexander Entinger, BSc
+* @brief this module receives the bytes of a serial receiver on USART1 (RXD1 = PD2) into a ring buffer
+* @file serial_rx.c
+*/
+
+#include "serial_rx.h"
+#include "timebase.h"
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*
+ * The receive interrupt only stores the byte together with its flags, the frames are decoded in the main loop.
+ * The ring buffer has a single producer (interrupt) and a single consumer (main loop): the interrupt only writes
+ * m_head, the main loop only writes m_tail, both are 8 bit so they are read and written atomically.
+ * 64 bytes hold a complete frame of every supported protocol and last 1.6 ms at 400000 baud. The flags of each byte
+ * are kept as one bit in a bitmap per flag, which needs 16 bytes instead of 64.
+ */
+#define SERIAL_RX_RING_SIZE		(64) // power of 2
+#define SERIAL_RX_MIN_GAP_MS	(2) // more than 1 ms between two bytes
+
+static volatile uint8_t m_ring[SERIAL_RX_RING_SIZE];
+static volatile uint8_t m_gap[SERIAL_RX_RING_SIZE / 8]; // SERIAL_RX_GAP of each entry, bit (idx & 7) of byte (idx >> 3)
+static volatile uint8_t m_error[SERIAL_RX_RING_SIZE / 8]; // SERIAL_RX_ERROR of each entry
+static volatile uint8_t m_head = 0; // next entry written by the interrupt
+static volatile uint8_t m_tail = 0; // next entry read by the main loop
+static volatile bool m_lost = false; // a byte was dropped since the ring buffer was full
+
+/**
+ * @brief starts receiving with the given baudrate and frame format (UCSR1C)
+ */
+void enable_serial_rx(uint32_t const baudrate, bool const double_speed, uint8_t const frame_format) {
+	UCSR1B = 0;
+	m_tail = m_head;
+	m_lost = false;
+	// RXD1 as input with pullup, so an unconnected line stays idle. TXD1 (PD3) is not touched, only the receiver is used
+	DDRD &= ~(1<<PORTD2);
+	PORTD |= (1<<PORTD2);
+	// baud rate register: f_cpu / (16 * baudrate) - 1, f_cpu / (8 * baudrate) - 1 with double speed, rounded
+	uint32_t const divider = double_speed ? (F_CPU / 8) : (F_CPU / 16);
+	UBRR1 = (uint16_t)((divider + (baudrate / 2)) / baudrate - 1);
+	UCSR1A = double_speed ? (1<<U2X1) : 0;
+	UCSR1C = frame_format;
+	UCSR1B = (1<<RXEN1) | (1<<RXCIE1);
+}
+
+/**
+ * @brief stops receiving and releases the usart and the pullup of RXD1
+ */
+void disable_serial_rx() {
+	UCSR1B = 0;
+	UCSR1A = 0;
+	UCSR1C = 0;
+	UBRR1 = 0;
+	PORTD &= ~(1<<PORTD2);
+	m_tail = m_head;
+}
+
+/**
+ * @brief takes the oldest received byte from the ring buffer, called from the main loop
+ * @return false if the ring buffer is empty
+ */
+bool serial_rx_get(uint8_t *data, uint8_t *flags) {
+	uint8_t const tail = m_tail;
+	if(tail == m_head) return false;
+	uint8_t const bit = 1 << (tail & 7);
+	*data = m_ring[tail];
+	*flags = 0;
+	if(m_gap[tail >> 3] & bit) *flags |= SERIAL_RX_GAP;
+	if(m_error[tail >> 3] & bit) *flags |= SERIAL_RX_ERROR;
+	m_tail = (tail + 1) & (SERIAL_RX_RING_SIZE - 1);
+	return true;
+}
+
+/**
+ * @brief receive interrupt of USART1, stores the byte with its flags in the ring buffer
+ */
+ISR(USART1_RX_vect) {
+	static uint16_t last_ms = 0;
+	
+	uint8_t const status = UCSR1A; // the error flags belong to the byte in UDR1 and must be read first
+	uint8_t const data = UDR1;
+	uint16_t const ms = timebase_ms();
+	
+	bool const gap = ((uint16_t)(ms - last_ms) >= SERIAL_RX_MIN_GAP_MS);
+	last_ms = ms;
+	bool const error = (status & ((1<<FE1) | (1<<DOR1) | (1<<UPE1))) || m_lost;
+	
+	uint8_t const head = m_head;
+	uint8_t const next = (head + 1) & (SERIAL_RX_RING_SIZE - 1);
+	if(next == m_tail) {
+		// full, the frame this byte belongs to is discarded by the error flag of the next stored byte
+		m_lost = true;
+		return;
+	}
+	uint8_t const bit = 1 << (head & 7);
+	m_ring[head] = data;
+	if(gap) m_gap[head >> 3] |= bit;
+	else m_gap[head >> 3] &= ~bit;
+	if(error) m_error[head >> 3] |= bit;
+	else m_error[head >> 3] &= ~bit;
+	m_head = next;
+	m_lost = false;
+}
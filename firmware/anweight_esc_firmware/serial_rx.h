@@ -0,0 +1,52 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @author Alexander Entinger, BSc
+* @brief this module receives the bytes of a serial receiver on USART1 (RXD1 = PD2) into a ring buffer
+* @file serial_rx.h
+*/
+
+#ifndef SERIAL_RX_H_
+#define SERIAL_RX_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// flags of a received byte
+#define SERIAL_RX_GAP		(1<<0) // the line was idle for more than 1 ms before the byte
+#define SERIAL_RX_ERROR		(1<<1) // framing, parity or overrun error or bytes lost since the ring buffer was full
+
+/**
+ * @brief starts receiving with the given baudrate and frame format (UCSR1C)
+ */
+void enable_serial_rx(uint32_t const baudrate, bool const double_speed, uint8_t const frame_format);
+
+/**
+ * @brief stops receiving and releases the usart and the pullup of RXD1
+ */
+void disable_serial_rx();
+
+/**
+ * @brief takes the oldest received byte from the ring buffer, called from the main loop
+ * @return false if the ring buffer is empty
+ */
+bool serial_rx_get(uint8_t *data, uint8_t *flags);
+
+#endif /* SERIAL_RX_H_ */
@@ -0,0 +1,64 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @author Alexander Entinger, BSc
+ * @brief this file implements a slew rate limiter for the motor speed
+ * @file slew_limiter.c
+ */
+
+#include "slew_limiter.h"
+
+/** 
+ * @brief initializes the slew limiter with the rates and an output value of 0
+ */
+void init_slew_limiter(slew_limiter *s, uint16_t const accel_rate, uint16_t const decel_rate, uint16_t const reversal_rate) {
+	s->value = 0;
+	s->accel_rate = accel_rate;
+	s->decel_rate = decel_rate;
+	s->reversal_rate = reversal_rate;
+}
+
+/**
+ * @brief sets the output value of the slew limiter to value without limiting
+ */
+void slew_limiter_reset(slew_limiter *s, int16_t const value) {
+	s->value = value;
+}
+
+/**
+ * @brief moves the output value towards target by at most the rate fitting the direction of the change and returns the new output value
+ */
+int16_t slew_limiter_update(slew_limiter *s, int16_t const target) {
+	int16_t const value = s->value;
+	
+	// select the rate: a target in the opposite direction is approached with the reversal rate
+	// (also through zero), otherwise it depends on whether the magnitude grows or shrinks
+	uint16_t rate = 0;
+	if((value > 0 && target < 0) || (value < 0 && target > 0)) rate = s->reversal_rate;
+	else if((value >= 0 && target > value) || (value <= 0 && target < value)) rate = s->accel_rate;
+	else rate = s->decel_rate;
+	
+	int32_t const diff = (int32_t)(target) - value;
+	if(rate == 0 || (diff <= (int32_t)(rate) && diff >= -(int32_t)(rate))) s->value = target;
+	else if(diff > 0) s->value = value + rate;
+	else s->value = value - rate;
+	
+	return s->value;
+}
@@ -0,0 +1,55 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @author Alexander Entinger, BSc
+ * @brief this file implements a slew rate limiter for the motor speed
+ * @file slew_limiter.h
+ */
+
+#ifndef SLEW_LIMITER_H_
+#define SLEW_LIMITER_H_
+
+#include <stdint.h>
+
+// definition of adt slew limiter, the value is signed: the sign is the direction, the magnitude the speed
+// all rates are the maximum change of the value per call of slew_limiter_update, a rate of 0 means unlimited
+typedef struct slew_limiter {
+	int16_t value;
+	uint16_t accel_rate; // magnitude increases, same direction
+	uint16_t decel_rate; // magnitude decreases, same direction
+	uint16_t reversal_rate; // the target is in the opposite direction
+} slew_limiter;
+
+/** 
+ * @brief initializes the slew limiter with the rates and an output value of 0
+ */
+void init_slew_limiter(slew_limiter *s, uint16_t const accel_rate, uint16_t const decel_rate, uint16_t const reversal_rate);
+
+/**
+ * @brief sets the output value of the slew limiter to value without limiting
+ */
+void slew_limiter_reset(slew_limiter *s, int16_t const value);
+
+/**
+ * @brief moves the output value towards target by at most the rate fitting the direction of the change and returns the new output value
+ */
+int16_t slew_limiter_update(slew_limiter *s, int16_t const target);
+
+#endif /* SLEW_LIMITER_H_ */
@@ -0,0 +1,68 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @author Alexander Entinger, BSc
+* @brief this module provides the system timebase with a tick of 1 ms
+* @file timebase.c
+*/
+
+#include "timebase.h"
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#define TIMEBASE_TICKS_PER_MS	(F_CPU / 1000) // tTimerStep = 62.5 ns
+
+static volatile uint16_t m_ms = 0;
+
+/** 
+ * @brief initializes the timebase, Timer 1 runs free with tTimerStep = 62.5 ns and is also used by the motor control and the input module
+ */
+void init_timebase() {
+	// set timer to zero
+	TCNT1 = 0;
+	
+	// output compare a generates the tick, the timer itself is not reset so it can still be used for the pwm and for measuring
+	OCR1A = TIMEBASE_TICKS_PER_MS;
+	TIMSK1 |= (1<<OCIE1A);
+	
+	// Prescaler = 1, tTimerStep = 62.5 ns, the timer wraps around every 4.096 ms
+	TCCR1B = (1<<CS10);
+}
+
+/**
+ * @brief returns the milliseconds since the start of the timebase, the value wraps around after 65.5 s
+ */
+uint16_t timebase_ms() {
+	uint16_t ms = 0;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		ms = m_ms;
+	}
+	return ms;
+}
+
+/**
+ * @brief timer 1 output compare a interrupt, occurs every 1 ms
+ */
+ISR(TIMER1_COMPA_vect) {
+	OCR1A += TIMEBASE_TICKS_PER_MS;
+	m_ms++;
+}
@@ -0,0 +1,41 @@
+/*
+	Copyright 2013 by Alexander Entinger, BSc
+
+    This file is part of antweight_esc_firmware.
+
+    antweight_esc_firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    antweight_esc_firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with antweight_esc_firmware.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @author Alexander Entinger, BSc
+* @brief this module provides the system timebase with a tick of 1 ms
+* @file timebase.h
+*/
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include <stdint.h>
+
+/** 
+ * @brief initializes the timebase, Timer 1 runs free with tTimerStep = 62.5 ns and is also used by the motor control and the input module
+ */
+void init_timebase();
+
+/**
+ * @brief returns the milliseconds since the start of the timebase, the value wraps around after 65.5 s
+ */
+uint16_t timebase_ms();
+
+#endif /* TIMEBASE_H_ */